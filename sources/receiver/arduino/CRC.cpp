@@ -21,15 +21,17 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "CRC.hpp"
 #include "Logger.hpp"
 
-uint16_t CRC16(const unsigned char* lpData, size_t nSize)
+uint16_t CRC16(
+  const unsigned char* lpData,
+  size_t               nSize,
+  uint16_t             nCRC
+)
 {
   // https://stackoverflow.com/questions/10564491/function-to-calculate-a-crc16-checksum
   // https://www.lammertbies.nl/comm/info/crc-calculation.html
 
   // CRC-CCITT (0xFFFF)
 
-  uint16_t nCRC = 0xFFFF;
-
   while (nSize--)
   {
     uint8_t nTemp  = (nCRC >> 8) ^ *lpData++;
@@ -23,6 +23,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "Arduino.h"
 
-uint16_t CRC16(const unsigned char* lpData, size_t nSize);
+// CRC-CCITT, pass a previous result as nCRC to continue it.
+
+uint16_t CRC16(
+  const unsigned char* lpData,
+  size_t               nSize,
+  uint16_t             nCRC = 0xFFFF
+);
 
 #endif /* _CRC_HPP_ */
@@ -0,0 +1,83 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "Compression.hpp"
+#include "Dictionary.hpp"
+
+const char     m_lpDictionaryData[]    PROGMEM = DICTIONARY_DATA;
+const uint16_t m_lpDictionaryOffsets[] PROGMEM = { DICTIONARY_OFFSETS };
+
+int Decompress(
+  const unsigned char* lpCompressed,
+  unsigned int         nSize,
+  char*                lpData,
+  unsigned int         nMaxSize
+)
+{
+  unsigned int nDataSize = 0;
+
+  for (unsigned int nIndex = 0; nIndex < nSize; nIndex++)
+  {
+    unsigned char cCode = lpCompressed[nIndex];
+
+    if (cCode < COMPRESSION_ENTRY_BASE)
+    {
+      if (nDataSize >= nMaxSize)
+      {
+        return -1;
+      }
+
+      lpData[nDataSize++] = cCode;
+    }
+    else if (COMPRESSION_ESCAPE == cCode)
+    {
+      if ((++nIndex >= nSize) || (nDataSize >= nMaxSize))
+      {
+        return -1;
+      }
+
+      lpData[nDataSize++] = lpCompressed[nIndex];
+    }
+    else
+    {
+      uint8_t nEntry = (cCode - COMPRESSION_ENTRY_BASE);
+
+      if (nEntry >= DICTIONARY_ENTRY_COUNT)
+      {
+        return -1;
+      }
+
+      uint16_t nStart = pgm_read_word(&m_lpDictionaryOffsets[nEntry]);
+      uint16_t nEnd   = pgm_read_word(&m_lpDictionaryOffsets[nEntry + 1]);
+
+      if ((nDataSize + (nEnd - nStart)) > nMaxSize)
+      {
+        return -1;
+      }
+
+      while (nStart < nEnd)
+      {
+        lpData[nDataSize++] = pgm_read_byte(&m_lpDictionaryData[nStart++]);
+      }
+    }
+  }
+
+  return nDataSize;
+}
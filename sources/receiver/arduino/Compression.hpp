@@ -0,0 +1,43 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef _COMPRESSION_HPP_
+#define _COMPRESSION_HPP_
+
+#include "Arduino.h"
+
+// Static dictionary decompressor, see transmitter library Compression.hpp.
+// The dictionary (Dictionary.hpp) is kept in flash memory.
+
+#define COMPRESSION_ENTRY_BASE 0x80
+#define COMPRESSION_ESCAPE     0xFF
+
+/*
+ * Returns the decompressed size, or -1 on overflow/bad data.
+ */
+
+int Decompress(
+  const unsigned char* lpCompressed,
+  unsigned int         nSize,
+  char*                lpData,
+  unsigned int         nMaxSize
+);
+
+#endif /* _COMPRESSION_HPP_ */
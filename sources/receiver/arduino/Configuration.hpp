@@ -27,10 +27,36 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define DECODER_BIT_ONE      1500
 #define DECODER_BIT_SYNC     2500
 
+/*
+ * Multi level line code (two bits per pulse): bit zero and bit one durations
+ * are used for symbols 00 and 01, set these ones for 10 and 11 (0 = binary).
+ */
+
+#define DECODER_SYMBOL_TWO   0
+#define DECODER_SYMBOL_THREE 0
+
 #define DECODER_PULLUP       false
 #define DECODER_STX          '\x02'
 #define DECODER_ETX          '\x03'
 #define DECODER_VALIDATE_CRC true
+#define DECODER_DECODE_FEC   false
+#define DECODER_DECOMPRESS   false
+#define DECODER_FRAME_SYNC   false
+
+/*
+ * Binary safe frames: a length byte (and its complement) follows STX, no ETX
+ * is expected.
+ */
+
+#define DECODER_LENGTH_PREFIX false
+
+/*
+ * Node addressing: frames not sent to DECODER_ADDRESS (nor broadcast) are
+ * dropped right after STX.
+ */
+
+#define DECODER_ADDRESSING   false
+#define DECODER_ADDRESS      1
 
 /*
  * Configure logging levels on:
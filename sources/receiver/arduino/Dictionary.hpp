@@ -0,0 +1,91 @@
+// Generated by gpiowire-dictionary, do not edit.
+// Copy it into both transmitter library and receiver project.
+
+#ifndef _DICTIONARY_HPP_
+#define _DICTIONARY_HPP_
+
+#define DICTIONARY_ENTRY_COUNT 38
+
+#define DICTIONARY_DATA \
+  "temperature=" \
+  ";humidity=" \
+  "battery=3." \
+  "heartbeat;node=" \
+  ";room=kitchen" \
+  "elay=on;channel=" \
+  "pressure=10" \
+  "motion=detected" \
+  "status=ok;node=" \
+  ";room=bathroom" \
+  ";uptime=" \
+  "=closed" \
+  "=open" \
+  " from GPIO wire!" \
+  ";node=" \
+  "=triggered;zone=" \
+  "ay=off;channel=1" \
+  "alarm=disarmed" \
+  ";room=living" \
+  "status=error" \
+  "alarm=armed" \
+  "battery=low" \
+  "light=" \
+  "motion=none" \
+  "water=" \
+  "window" \
+  "door" \
+  "smoke=none" \
+  "21." \
+  "3;code=17" \
+  "gate" \
+  "garage" \
+  "12;" \
+  "22." \
+  "23." \
+  "41;" \
+  "Hello" \
+  "alarm" \
+  ""
+
+#define DICTIONARY_OFFSETS \
+  0, \
+  12, \
+  22, \
+  32, \
+  47, \
+  60, \
+  76, \
+  87, \
+  102, \
+  117, \
+  131, \
+  139, \
+  146, \
+  151, \
+  167, \
+  173, \
+  189, \
+  205, \
+  219, \
+  231, \
+  243, \
+  254, \
+  265, \
+  271, \
+  282, \
+  288, \
+  294, \
+  298, \
+  308, \
+  311, \
+  320, \
+  324, \
+  330, \
+  333, \
+  336, \
+  339, \
+  342, \
+  347, \
+  352
+
+#endif /* _DICTIONARY_HPP_ */
@@ -0,0 +1,111 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "FEC.hpp"
+
+// Codeword bit positions (1..7): p1 p2 d1 p3 d2 d3 d4
+
+static uint8_t HammingDecode(uint8_t nCodeword, unsigned int& nCorrected)
+{
+  uint8_t nSyndrome =
+      (((nCodeword >> 0) ^ (nCodeword >> 2) ^ (nCodeword >> 4) ^ (nCodeword >> 6)) & 1)
+    | ((((nCodeword >> 1) ^ (nCodeword >> 2) ^ (nCodeword >> 5) ^ (nCodeword >> 6)) & 1) << 1)
+    | ((((nCodeword >> 3) ^ (nCodeword >> 4) ^ (nCodeword >> 5) ^ (nCodeword >> 6)) & 1) << 2)
+  ;
+
+  if (nSyndrome)
+  {
+    // Syndrome is the (1 based) position of the flipped bit
+
+    nCodeword ^= (1 << (nSyndrome - 1));
+    nCorrected++;
+  }
+
+  return
+      (((nCodeword >> 2) & 1) << 3)
+    | (((nCodeword >> 4) & 1) << 2)
+    | (((nCodeword >> 5) & 1) << 1)
+    |  ((nCodeword >> 6) & 1)
+  ;
+}
+
+bool FECDecode(
+  unsigned char* lpData,
+  unsigned int&  nSize,
+  unsigned int&  nCorrected
+)
+{
+  nCorrected = 0;
+
+  if ((0 == nSize) || (0 != (nSize % FEC_BLOCK_SIZE)))
+  {
+    return false;
+  }
+
+  uint8_t nPadding = 0;
+  uint8_t lpCodewords[FEC_BLOCK_SIZE];
+
+  for (unsigned int nBlock = 0; nBlock < nSize; nBlock += FEC_BLOCK_SIZE)
+  {
+    // De-interleave (the whole block is read before writing back, so
+    // decoded data never overwrites unread input)
+
+    for (uint8_t nIndex = 0; nIndex < FEC_BLOCK_SIZE; nIndex++)
+    {
+      lpCodewords[nIndex] = 0;
+
+      for (uint8_t nBit = 0; nBit < FEC_BLOCK_SIZE; nBit++)
+      {
+        lpCodewords[nIndex] |= (((lpData[nBlock + nBit] >> nIndex) & 1) << nBit);
+      }
+    }
+
+    for (uint8_t nIndex = 0; nIndex < FEC_BLOCK_SIZE; nIndex++)
+    {
+      unsigned int nNibble = (nBlock + nIndex);
+      uint8_t      nValue  = HammingDecode(lpCodewords[nIndex], nCorrected);
+
+      if (0 == nNibble)
+      {
+        nPadding = nValue;
+      }
+      else if (nNibble & 1)
+      {
+        lpData[(nNibble - 1) / 2] = (nValue << 4);
+      }
+      else
+      {
+        lpData[(nNibble - 1) / 2] |= nValue;
+      }
+    }
+  }
+
+  if (
+       (nPadding >= FEC_BLOCK_SIZE)
+    || (0 != ((nSize - 1 - nPadding) % 2))
+  )
+  {
+    return false;
+  }
+
+  nSize = ((nSize - 1 - nPadding) / 2);
+
+  return true;
+}
@@ -0,0 +1,40 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef _FEC_HPP_
+#define _FEC_HPP_
+
+#include "Arduino.h"
+
+// Interleaved Hamming(7,4) decoder, see transmitter library FEC.hpp.
+
+#define FEC_BLOCK_SIZE 7
+
+/*
+ * Decodes in place (7 bytes of stack only), returns false on malformed data.
+ */
+
+bool FECDecode(
+  unsigned char* lpData,
+  unsigned int&  nSize,
+  unsigned int&  nCorrected
+);
+
+#endif /* _FEC_HPP_ */
@@ -0,0 +1,137 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+#include <assert.h>
+
+#include "Fragments.hpp"
+
+void FragmentsInitialize(
+  FragmentAssembler& Assembler,
+  char*              lpBuffer,
+  unsigned int       nBufferSize,
+  uint8_t*           lpBitmap,
+  uint8_t            nBitmapSize,
+  uint8_t            nMTU
+)
+{
+  assert(lpBuffer);
+  assert(lpBitmap);
+  assert(nMTU > FRAGMENT_HEADER);
+
+  Assembler.lpBuffer    = lpBuffer;
+  Assembler.nBufferSize = nBufferSize;
+  Assembler.lpBitmap    = lpBitmap;
+  Assembler.nBitmapSize = nBitmapSize;
+  Assembler.nChunkSize  = (nMTU - FRAGMENT_HEADER);
+  Assembler.bActive     = false;
+  Assembler.nMessageId  = 0;
+  Assembler.nCount      = 0;
+  Assembler.nReceived   = 0;
+  Assembler.nSize       = 0;
+}
+
+FragmentResult FragmentsAdd(
+  FragmentAssembler& Assembler,
+  const char*        lpFragment,
+  unsigned int       nSize
+)
+{
+  if (nSize < FRAGMENT_HEADER)
+  {
+    return FragmentResult::Invalid;
+  }
+
+  uint8_t      nMessageId = (uint8_t)lpFragment[0];
+  uint8_t      nIndex     = (uint8_t)lpFragment[1];
+  uint8_t      nCount     = (uint8_t)lpFragment[2];
+  unsigned int nChunk     = (nSize - FRAGMENT_HEADER);
+
+  if (
+       (0 == nCount)
+    || (nIndex >= nCount)
+    || (nChunk > Assembler.nChunkSize)
+    || ((nIndex < (nCount - 1)) && (nChunk != Assembler.nChunkSize))
+  )
+  {
+    return FragmentResult::Invalid;
+  }
+
+  // A new message id (or count) restarts the reassembly
+
+  if (
+       !Assembler.bActive
+    || (nMessageId != Assembler.nMessageId)
+    || (nCount     != Assembler.nCount)
+  )
+  {
+    if (((nCount + 7) / 8) > Assembler.nBitmapSize)
+    {
+      return FragmentResult::Overflow;
+    }
+
+    memset(Assembler.lpBitmap, 0, Assembler.nBitmapSize);
+
+    Assembler.bActive    = true;
+    Assembler.nMessageId = nMessageId;
+    Assembler.nCount     = nCount;
+    Assembler.nReceived  = 0;
+    Assembler.nSize      = 0;
+  }
+
+  uint8_t nMask = (1 << (nIndex % 8));
+
+  if (Assembler.lpBitmap[nIndex / 8] & nMask)
+  {
+    return FragmentResult::Duplicate;
+  }
+
+  unsigned int nOffset = ((unsigned int)nIndex * Assembler.nChunkSize);
+
+  if ((nOffset + nChunk) > Assembler.nBufferSize)
+  {
+    return FragmentResult::Overflow;
+  }
+
+  memcpy(
+    (Assembler.lpBuffer + nOffset),
+    (lpFragment + FRAGMENT_HEADER),
+    nChunk
+  );
+
+  Assembler.lpBitmap[nIndex / 8] |= nMask;
+  Assembler.nReceived++;
+
+  if (nIndex == (nCount - 1))
+  {
+    Assembler.nSize = (nOffset + nChunk);
+  }
+
+  return (
+      (Assembler.nReceived == Assembler.nCount)
+    ? FragmentResult::Complete
+    : FragmentResult::Added
+  );
+}
+
+unsigned int FragmentsGetSize(const FragmentAssembler& Assembler)
+{
+  return Assembler.nSize;
+}
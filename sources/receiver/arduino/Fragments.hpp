@@ -0,0 +1,80 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+#ifndef _FRAGMENTS_HPP_
+#define _FRAGMENTS_HPP_
+
+#include "Arduino.h"
+
+// Fragments reassembly, see transmitter library CGPIOWire::SendFragments().
+// Fragment payload: message id, fragment index, fragment count, data.
+
+#define FRAGMENT_HEADER 3
+
+enum class FragmentResult
+{
+  Added     = 0,
+  Complete  = 1,
+  Duplicate = 2,
+  Invalid   = 3,
+  Overflow  = 4  // Message larger than the reassembly buffer or bitmap
+};
+
+struct FragmentAssembler
+{
+  char*        lpBuffer;
+  unsigned int nBufferSize;
+  uint8_t*     lpBitmap;    // Bit N % 8 of byte N / 8 set = fragment N got
+  uint8_t      nBitmapSize;
+  uint8_t      nChunkSize;  // MTU - FRAGMENT_HEADER
+  bool         bActive;
+  uint8_t      nMessageId;
+  uint8_t      nCount;
+  uint8_t      nReceived;
+  unsigned int nSize;
+};
+
+/*
+ * Buffer and bitmap are owned by the caller. The bitmap can be sent back to
+ * the transmitter, so that only missing fragments get resent. nMTU must
+ * match the transmitter one.
+ */
+
+void FragmentsInitialize(
+  FragmentAssembler& Assembler,
+  char*              lpBuffer,
+  unsigned int       nBufferSize,
+  uint8_t*           lpBitmap,
+  uint8_t            nBitmapSize,
+  uint8_t            nMTU
+);
+
+FragmentResult FragmentsAdd(
+  FragmentAssembler& Assembler,
+  const char*        lpFragment,
+  unsigned int       nSize
+);
+
+// Reassembled message size (valid once FragmentResult::Complete is got).
+
+unsigned int FragmentsGetSize(const FragmentAssembler& Assembler);
+
+#endif /* _FRAGMENTS_HPP_ */
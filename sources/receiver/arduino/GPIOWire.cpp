@@ -23,6 +23,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "Arduino.h"
 
 #include "CRC.hpp"
+#include "FEC.hpp"
 #include "GPIOWire.hpp"
 #include "Logger.hpp"
 
@@ -38,7 +39,17 @@ namespace GPIOWire {
     WaitingForETX  = 1,
     MessageDecoded = 2,
     MessageGot     = 3,
-    Overflow       = 4
+    Overflow       = 4,
+
+    // Length prefixed frames: STX, LEN, ~LEN, LEN bytes (no ETX)
+
+    WaitingForLength      = 5,
+    WaitingForLengthCheck = 6,
+    WaitingForPayload     = 7,
+
+    // Addressed frames: STX, ADDR, ...
+
+    WaitingForAddress     = 8
   };
 
   enum class DecoderStatus
@@ -49,9 +60,17 @@ namespace GPIOWire {
   };
 
   bool                   m_bStarted = false;
+  bool                   m_bFrameSync;
+  bool                   m_bLengthPrefix;
+  bool                   m_bAddressing = false;
+  uint8_t                m_nAddress;
+  uint8_t                m_nFrameAddress;
+  bool                   m_bMultiLevel;
 
   unsigned int           m_nBitMidPoint;
   unsigned int           m_nBitLowPoint;
+  unsigned int           m_nSymbolTwoMidPoint;
+  unsigned int           m_nSymbolThreeMidPoint;
   unsigned int           m_nSyncMidPoint;
   volatile unsigned long m_nLastSampling;
 
@@ -63,12 +82,34 @@ namespace GPIOWire {
   GPIOWireBuffer         m_lpBuffer;
   volatile unsigned int  m_nBufferIndex;
   unsigned int           m_nBufferSize;
+  unsigned int           m_nFrameLength;
   volatile BufferStatus  m_eBufferStatus;
   char                   m_cSTX;
   char                   m_cETX;
+  unsigned int           m_nCorrectedBits;
 
   LOG_DECLARE_BUFFER();
 
+  inline bool IsReceivingFrame()
+  {
+    return (
+         (BufferStatus::WaitingForETX         == m_eBufferStatus)
+      || (BufferStatus::WaitingForAddress     == m_eBufferStatus)
+      || (BufferStatus::WaitingForLength      == m_eBufferStatus)
+      || (BufferStatus::WaitingForLengthCheck == m_eBufferStatus)
+      || (BufferStatus::WaitingForPayload     == m_eBufferStatus)
+    );
+  }
+
+  inline BufferStatus GetFrameBodyStatus()
+  {
+    return (
+        m_bLengthPrefix
+      ? BufferStatus::WaitingForLength
+      : BufferStatus::WaitingForETX
+    );
+  }
+
   inline void ProcessDecodedData(char cData)
   {
     switch (m_eBufferStatus)
@@ -76,7 +117,11 @@ namespace GPIOWire {
       case BufferStatus::WaitingForSTX :
         if (cData == m_cSTX)
         {
-          m_eBufferStatus = BufferStatus::WaitingForETX;
+          m_eBufferStatus = (
+              m_bAddressing
+            ? BufferStatus::WaitingForAddress
+            : GetFrameBodyStatus()
+          );
 
           #if DECODER_LOG_LEVEL & DECODER_LOG_MASK_BUFFER
             LOG("Wire: STX.");
@@ -132,6 +177,84 @@ namespace GPIOWire {
 
         break;
 
+      case BufferStatus::WaitingForAddress :
+        if (
+             ((uint8_t)cData == m_nAddress)
+          || ((uint8_t)cData == DECODER_BROADCAST_ADDRESS)
+        )
+        {
+          m_nFrameAddress = (uint8_t)cData;
+          m_eBufferStatus = GetFrameBodyStatus();
+        }
+        else
+        {
+          // Not for us: dropped before buffering anything
+
+          m_eBufferStatus = BufferStatus::WaitingForSTX;
+
+          #if DECODER_LOG_LEVEL & DECODER_LOG_MASK_BUFFER
+            LOG_FMT("Wire: foreign frame (0x%02X).", (uint8_t)cData);
+          #endif
+        }
+
+        break;
+
+      case BufferStatus::WaitingForLength :
+        m_nFrameLength = (uint8_t)cData;
+
+        if ((m_nFrameLength > 0) && (m_nFrameLength <= m_nBufferSize))
+        {
+          m_eBufferStatus = BufferStatus::WaitingForLengthCheck;
+        }
+        else
+        {
+          // Dropped as soon as the header arrives
+
+          m_eBufferStatus = BufferStatus::WaitingForSTX;
+
+          #if DECODER_LOG_LEVEL & DECODER_LOG_MASK_BUFFER
+            LOG_FMT("Wire: bad length (%d).", m_nFrameLength);
+          #endif
+        }
+
+        break;
+
+      case BufferStatus::WaitingForLengthCheck :
+        if ((uint8_t)cData == (uint8_t)~m_nFrameLength)
+        {
+          m_eBufferStatus = BufferStatus::WaitingForPayload;
+
+          #if DECODER_LOG_LEVEL & DECODER_LOG_MASK_BUFFER
+            LOG_FMT("Wire: length %d.", m_nFrameLength);
+          #endif
+        }
+        else
+        {
+          m_eBufferStatus = BufferStatus::WaitingForSTX;
+
+          #if DECODER_LOG_LEVEL & DECODER_LOG_MASK_BUFFER
+            LOG("Wire: bad length check.");
+          #endif
+        }
+
+        break;
+
+      case BufferStatus::WaitingForPayload :
+        m_lpBuffer[m_nBufferIndex] = cData;
+        m_nBufferIndex++;
+
+        if (m_nBufferIndex >= m_nFrameLength)
+        {
+          Stop();
+          m_eBufferStatus = BufferStatus::MessageDecoded;
+
+          #if DECODER_LOG_LEVEL & DECODER_LOG_MASK_BUFFER
+            LOG("Wire: frame complete.");
+          #endif
+        }
+
+        break;
+
       default:
         // Avoid Sloeber / Eclipse warnings for not handled cases.
 
@@ -182,12 +305,55 @@ namespace GPIOWire {
         m_eDecoderStatus = DecoderStatus::WaitingForSync;
         m_nDecodedBits   = 0;
         m_nDecodingData  = 0;
+
+        if (m_bFrameSync && IsReceivingFrame())
+        {
+          // Byte alignment lost, drop the frame until next STX
+
+          m_eBufferStatus = BufferStatus::WaitingForSTX;
+        }
+      }
+      else if (
+           m_bFrameSync
+        && (DecoderStatus::WaitingForSync == m_eDecoderStatus)
+      )
+      {
+        // Not aligned to any sync preamble yet: ignore data pulses
       }
       else
       {
         // Decode bits
 
-        if (m_nDecodedBits < 8)
+        if (m_bMultiLevel && (m_nDecodedBits < 8))
+        {
+          // Decode two bits symbol
+
+          m_nDecodedBits += 2;
+
+          m_eDecoderStatus           = DecoderStatus::Decoding;
+          unsigned char nSymbolValue = (
+              (nPulseDuration < m_nBitMidPoint)
+            ? 0
+            : (nPulseDuration < m_nSymbolTwoMidPoint)
+            ? 1
+            : (nPulseDuration < m_nSymbolThreeMidPoint)
+            ? 2
+            : 3
+          );
+
+          #if DECODER_LOG_LEVEL & DECODER_LOG_MASK_BIT
+            LOG_FMT(
+              "Wire: bits #%i = %d (%lu uS).",
+              m_nDecodedBits,
+              nSymbolValue,
+              nPulseDuration
+            );
+          #endif
+
+          m_nDecodingData <<= 2;
+          m_nDecodingData  |= nSymbolValue;
+        }
+        else if (m_nDecodedBits < 8)
         {
           // Decode bit
 
@@ -224,7 +390,14 @@ namespace GPIOWire {
 
           ProcessDecodedData(m_nDecodingData);
 
-          m_eDecoderStatus = DecoderStatus::WaitingForSync;
+          // In frame sync mode bytes follow each other without sync bits
+
+          m_eDecoderStatus = (
+              m_bFrameSync
+            ? DecoderStatus::WaitingForData
+            : DecoderStatus::WaitingForSync
+          );
+
           m_nDecodedBits   = 0;
           m_nDecodingData  = 0;
         }
@@ -233,6 +406,39 @@ namespace GPIOWire {
     }
   }
 
+  bool DecodeFEC()
+  {
+    unsigned int nSize = m_nBufferIndex;
+
+    bool bValid = FECDecode(
+      (unsigned char*)m_lpBuffer,
+      nSize,
+      m_nCorrectedBits
+    );
+
+    #if DECODER_LOG_LEVEL & DECODER_LOG_MASK_FEC
+      if (bValid)
+      {
+        LOG_FMT(
+          "Wire: FEC decoded %d byte(s), %d bit(s) corrected.",
+          nSize,
+          m_nCorrectedBits
+        );
+      }
+      else
+      {
+        LOG("Wire: bad FEC, invalid buffer size.");
+      }
+    #endif
+
+    if (bValid)
+    {
+      m_nBufferIndex = nSize;
+    }
+
+    return bValid;
+  }
+
   bool ValidateCRC()
   {
     if (m_nBufferIndex < 2)
@@ -244,9 +450,12 @@ namespace GPIOWire {
       return false;
     }
 
+    // The destination address is covered by CRC as well
+
     uint16_t nCalculatedCRC = CRC16(
       (const unsigned char*)m_lpBuffer,
-      (m_nBufferIndex - 2)
+      (m_nBufferIndex - 2),
+      (m_bAddressing ? CRC16(&m_nFrameAddress, 1) : 0xFFFF)
     );
 
     uint16_t nPassedCRC =
@@ -286,14 +495,36 @@ namespace GPIOWire {
   /* Public */
   /**********/
 
-  MessageResult GetMessage(GPIOWireBuffer& lpMessage, bool bValidateCRC)
+  unsigned int GetMessageSize()
+  {
+    return m_nBufferIndex;
+  }
+
+  unsigned int GetCorrectedBits()
+  {
+    return m_nCorrectedBits;
+  }
+
+  MessageResult GetMessage(
+    GPIOWireBuffer& lpMessage,
+    bool            bValidateCRC,
+    bool            bDecodeFEC
+  )
   {
     if (BufferStatus::MessageDecoded != m_eBufferStatus)
     {
       return MessageResult::NotYetAvailable;
     }
 
-    m_eBufferStatus = BufferStatus::MessageGot;
+    m_eBufferStatus  = BufferStatus::MessageGot;
+    m_nCorrectedBits = 0;
+
+    // Errors are corrected before checking CRC
+
+    if (bDecodeFEC && !DecodeFEC())
+    {
+      return MessageResult::BadFEC;
+    }
 
     if (bValidateCRC && !ValidateCRC())
     {
@@ -306,6 +537,11 @@ namespace GPIOWire {
     return MessageResult::Valid;
   }
 
+  uint8_t GetMessageAddress()
+  {
+    return m_nFrameAddress;
+  }
+
   bool HasMessage()
   {
     return (BufferStatus::MessageDecoded == m_eBufferStatus);
@@ -323,7 +559,11 @@ namespace GPIOWire {
     unsigned int nSyncBit,
     bool         bPullUp,
     char         cSTX,
-    char         cETX
+    char         cETX,
+    bool         bFrameSync,
+    unsigned int nSymbolTwo,
+    unsigned int nSymbolThree,
+    bool         bLengthPrefix
   )
   {
     assert(nBitZero > 0);
@@ -332,16 +572,39 @@ namespace GPIOWire {
 
     m_cSTX           = cSTX;
     m_cETX           = cETX;
+    m_bFrameSync     = bFrameSync;
+    m_bLengthPrefix  = bLengthPrefix;
+    m_bMultiLevel    = (nSymbolTwo > 0);
 
     m_nBitMidPoint   = ((nBitOne + nBitZero) / 2);
     m_nBitLowPoint   = (nBitZero - (m_nBitMidPoint - nBitZero));
     m_nSyncMidPoint  = ((nSyncBit + nBitOne) / 2);
 
+    if (m_bMultiLevel)
+    {
+      assert(nSymbolTwo   > nBitOne);
+      assert(nSymbolThree > nSymbolTwo);
+      assert(nSyncBit     > nSymbolThree);
+
+      m_nSymbolTwoMidPoint   = ((nSymbolTwo   + nBitOne)      / 2);
+      m_nSymbolThreeMidPoint = ((nSymbolThree + nSymbolTwo)   / 2);
+      m_nSyncMidPoint        = ((nSyncBit     + nSymbolThree) / 2);
+    }
+
     #if DECODER_LOG_LEVEL & DECODER_LOG_MASK_CONTROLLER
       LOG_FMT("Wire: bit 0 = %lu us.", nBitZero);
       LOG_FMT("Wire: bit 1 = %lu us.", nBitOne);
       LOG_FMT("Wire: bit S = %lu us.", nSyncBit);
 
+      if (m_bMultiLevel)
+      {
+        LOG_FMT("Wire: sym 2 = %lu us.", nSymbolTwo);
+        LOG_FMT("Wire: sym 3 = %lu us.", nSymbolThree);
+
+        LOG_FMT("Wire: sym 2 mid pt = %lu us.", m_nSymbolTwoMidPoint);
+        LOG_FMT("Wire: sym 3 mid pt = %lu us.", m_nSymbolThreeMidPoint);
+      }
+
       LOG_FMT("Wire: bit low pt  = %lu us.", m_nBitLowPoint);
       LOG_FMT("Wire: bit mid pt  = %lu us.", m_nBitMidPoint);
       LOG_FMT("Wire: sync mid pt = %lu us.", m_nSyncMidPoint);
@@ -361,6 +624,12 @@ namespace GPIOWire {
     );
   }
 
+  void SetAddress(bool bAddressing, uint8_t nAddress)
+  {
+    m_bAddressing = bAddressing;
+    m_nAddress    = nAddress;
+  }
+
   void Start()
   {
     Stop();
@@ -34,12 +34,14 @@ namespace GPIOWire {
   #define DECODER_LOG_MASK_NOISE           64
   #define DECODER_LOG_MASK_CRC_CALC        128
   #define DECODER_LOG_MASK_CRC_ERROR       256
+  #define DECODER_LOG_MASK_FEC             512
 
   #define DECODER_LOG_LEVEL \
       DECODER_LOG_MASK_CRC_ERROR \
     + DECODER_LOG_MASK_CONTROLLER
 
   #define DECODER_BUFFER_SIZE              64
+  #define DECODER_BROADCAST_ADDRESS        0xFF
   #define DECODER_PULSES_DEBUG_BUFFER_SIZE ((8 + 2) * 3)
 
   typedef
@@ -49,7 +51,8 @@ namespace GPIOWire {
   {
     Valid           = 0,
     NotYetAvailable = 1,
-    BadCRC          = 2
+    BadCRC          = 2,
+    BadFEC          = 3
   };
 
   void Initialize(
@@ -59,16 +62,41 @@ namespace GPIOWire {
     unsigned int nSyncBit,
     bool         bPullUp,
     char         cSTX,
-    char         cETX
+    char         cETX,
+    bool         bFrameSync    = false, // Sync preamble per frame, not per byte
+    unsigned int nSymbolTwo    = 0,     // Two bits per pulse (0 = binary)
+    unsigned int nSymbolThree  = 0,
+    bool         bLengthPrefix = false  // STX, LEN, ~LEN, payload (no ETX)
   );
 
+  // Addressed frames: a destination byte follows STX (covered by CRC), frames
+  // not sent to nAddress nor broadcast are dropped as soon as it arrives.
+
+  void          SetAddress(bool bAddressing, uint8_t nAddress);
+
   void          Start();
   void          Stop();
 
   bool          HasMessage();
   bool          IsStarted();
 
-  MessageResult GetMessage(GPIOWireBuffer& lpMessage, bool bValidateCRC);
+  MessageResult GetMessage(
+    GPIOWireBuffer& lpMessage,
+    bool            bValidateCRC,
+    bool            bDecodeFEC = false
+  );
+
+  // Size of the last got message (binary payloads may contain '\0').
+
+  unsigned int  GetMessageSize();
+
+  // Bits corrected by FEC in the last got message.
+
+  unsigned int  GetCorrectedBits();
+
+  // Destination address of the last got message (addressing only).
+
+  uint8_t       GetMessageAddress();
 }
 
 #endif /* _GPIOWire_H_ */
@@ -32,9 +32,15 @@ void setup()
     DECODER_BIT_SYNC,
     DECODER_PULLUP,
     DECODER_STX,
-    DECODER_ETX
+    DECODER_ETX,
+    DECODER_FRAME_SYNC,
+    DECODER_SYMBOL_TWO,
+    DECODER_SYMBOL_THREE,
+    DECODER_LENGTH_PREFIX
   );
 
+  GPIOWire::SetAddress(DECODER_ADDRESSING, DECODER_ADDRESS);
+
   GPIOWire::Start();
 }
 
@@ -45,10 +51,44 @@ void loop()
 
   GPIOWire::GPIOWireBuffer lpMessage;
 
-  switch (GPIOWire::GetMessage(lpMessage, DECODER_VALIDATE_CRC))
+  switch (GPIOWire::GetMessage(
+    lpMessage,
+    DECODER_VALIDATE_CRC,
+    DECODER_DECODE_FEC
+  ))
   {
     case GPIOWire::MessageResult::Valid :
-	  LOG_FMT("Got message \"%s\".", lpMessage);
+      if (DECODER_DECOMPRESS)
+      {
+        GPIOWire::GPIOWireBuffer lpText;
+
+        int iSize = Decompress(
+          (const unsigned char*)lpMessage,
+          GPIOWire::GetMessageSize(),
+          lpText,
+          (sizeof(lpText) - 1)
+        );
+
+        if (iSize < 0)
+        {
+          LOG("Bad compressed message!");
+        }
+        else
+        {
+          lpText[iSize] = '\0';
+          LOG_FMT("Got message \"%s\".", lpText);
+        }
+      }
+      else
+      {
+        LOG_FMT("Got message \"%s\".", lpMessage);
+      }
+
+      if (DECODER_DECODE_FEC)
+      {
+        LOG_FMT("FEC corrected %u bit(s).", GPIOWire::GetCorrectedBits());
+      }
+
       GPIOWire::Start();
 
       break;
@@ -59,6 +99,12 @@ void loop()
 
       break;
 
+    case GPIOWire::MessageResult::BadFEC :
+      LOG("Bad FEC!");
+      GPIOWire::Start();
+
+      break;
+
     case GPIOWire::MessageResult::NotYetAvailable :
       // Do nothing so far...
       break;
@@ -27,6 +27,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "Configuration.hpp"
 
+#include "Compression.hpp"
 #include "GPIOWire.hpp"
 #include "Logger.hpp"
 
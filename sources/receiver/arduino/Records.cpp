@@ -0,0 +1,82 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "Records.hpp"
+
+bool RecordsBegin(
+  RecordIterator& Iterator,
+  const char*     lpData,
+  unsigned int    nSize
+)
+{
+  Iterator.lpData  = lpData;
+  Iterator.nCount  = 0;
+  Iterator.nIndex  = 0;
+  Iterator.nOffset = 0;
+
+  if (nSize < 1)
+  {
+    return false;
+  }
+
+  uint8_t      nCount = (uint8_t)lpData[0];
+  unsigned int nTotal = (1 + nCount);
+
+  if (nTotal > nSize)
+  {
+    return false;
+  }
+
+  for (uint8_t nIndex = 0; nIndex < nCount; nIndex++)
+  {
+    nTotal += (uint8_t)lpData[1 + nIndex];
+  }
+
+  if (nTotal != nSize)
+  {
+    return false;
+  }
+
+  Iterator.nCount  = nCount;
+  Iterator.nOffset = (1 + nCount);
+
+  return true;
+}
+
+bool RecordsNext(
+  RecordIterator& Iterator,
+  const char*&    lpRecord,
+  uint8_t&        nRecordSize
+)
+{
+  if (Iterator.nIndex >= Iterator.nCount)
+  {
+    return false;
+  }
+
+  nRecordSize = (uint8_t)Iterator.lpData[1 + Iterator.nIndex];
+  lpRecord    = (Iterator.lpData + Iterator.nOffset);
+
+  Iterator.nOffset += nRecordSize;
+  Iterator.nIndex++;
+
+  return true;
+}
@@ -0,0 +1,55 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+#ifndef _RECORDS_HPP_
+#define _RECORDS_HPP_
+
+#include "Arduino.h"
+
+// Batched records iterator, see transmitter library CGPIOWire::AddRecord().
+// Payload: record count, one length byte per record, records.
+
+struct RecordIterator
+{
+  const char*  lpData;
+  unsigned int nOffset;
+  uint8_t      nCount;
+  uint8_t      nIndex;
+};
+
+/*
+ * Records are not copied: they point into the GetMessage() buffer, so it
+ * must not be overwritten while iterating. Returns false on a bad index.
+ */
+
+bool RecordsBegin(
+  RecordIterator& Iterator,
+  const char*     lpData,
+  unsigned int    nSize
+);
+
+bool RecordsNext(
+  RecordIterator& Iterator,
+  const char*&    lpRecord,
+  uint8_t&        nRecordSize
+);
+
+#endif /* _RECORDS_HPP_ */
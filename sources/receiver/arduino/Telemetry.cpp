@@ -0,0 +1,172 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "Telemetry.hpp"
+
+static bool ReadBits(
+  TelemetryDecoder& Decoder,
+  uint8_t           nBits,
+  uint32_t&         nValue
+)
+{
+  if ((Decoder.nBitIndex + nBits) > (Decoder.nSize * 8UL))
+  {
+    return false;
+  }
+
+  nValue = 0;
+
+  while (nBits--)
+  {
+    unsigned char nByte = Decoder.lpData[Decoder.nBitIndex / 8];
+
+    nValue = ((nValue << 1) | ((nByte >> (7 - (Decoder.nBitIndex % 8))) & 1));
+
+    Decoder.nBitIndex++;
+  }
+
+  return true;
+}
+
+static bool ReadField(
+  TelemetryDecoder&     Decoder,
+  const TelemetryField& Field,
+  uint32_t&             nValue
+)
+{
+  if (!(Field.nFlags & TELEMETRY_VARINT))
+  {
+    return ReadBits(Decoder, Field.nBits, nValue);
+  }
+
+  uint32_t nContinue;
+  uint32_t nGroup;
+  uint8_t  nShift = 0;
+
+  nValue = 0;
+
+  do
+  {
+    if (
+         (nShift >= 32)
+      || !ReadBits(Decoder, 1, nContinue)
+      || !ReadBits(Decoder, Field.nBits, nGroup)
+    )
+    {
+      return false;
+    }
+
+    nValue |= (nGroup << nShift);
+    nShift += Field.nBits;
+  }
+  while (nContinue);
+
+  return true;
+}
+
+static inline int32_t UnZigZag(uint32_t nValue)
+{
+  return (int32_t)((nValue >> 1) ^ (0 - (nValue & 1)));
+}
+
+void TelemetryInitialize(TelemetryDecoder& Decoder)
+{
+  Decoder.lpData    = NULL;
+  Decoder.nSize     = 0;
+  Decoder.nBitIndex = 0;
+  Decoder.nRecords  = 0;
+  Decoder.bHasKey   = false;
+}
+
+void TelemetryBegin(
+  TelemetryDecoder&    Decoder,
+  const unsigned char* lpData,
+  unsigned int         nSize
+)
+{
+  Decoder.lpData    = lpData;
+  Decoder.nSize     = nSize;
+  Decoder.nBitIndex = 8;
+  Decoder.nRecords  = (nSize ? lpData[0] : 0);
+}
+
+TelemetryResult TelemetryNext(
+  TelemetryDecoder&     Decoder,
+  const TelemetryField* lpSchema,
+  uint8_t               nFields,
+  int32_t*              lpValues
+)
+{
+  if (!Decoder.nRecords)
+  {
+    return TelemetryResult::Done;
+  }
+
+  Decoder.nRecords--;
+
+  uint32_t nKey;
+
+  if (!ReadBits(Decoder, 1, nKey))
+  {
+    Decoder.nRecords = 0;
+    Decoder.bHasKey  = false;
+
+    return TelemetryResult::Malformed;
+  }
+
+  bool bMissingKey = (!nKey && !Decoder.bHasKey);
+
+  for (uint8_t nIndex = 0; nIndex < nFields; nIndex++)
+  {
+    const TelemetryField& Field = lpSchema[nIndex];
+    uint32_t              nValue;
+
+    if (!ReadField(Decoder, Field, nValue))
+    {
+      Decoder.nRecords = 0;
+      Decoder.bHasKey  = false;
+
+      return TelemetryResult::Malformed;
+    }
+
+    if (!nKey && (Field.nFlags & TELEMETRY_DELTA))
+    {
+      lpValues[nIndex] = (int32_t)(
+        (uint32_t)lpValues[nIndex] + (uint32_t)UnZigZag(nValue)
+      );
+    }
+    else if (Field.nFlags & TELEMETRY_SIGNED)
+    {
+      lpValues[nIndex] = UnZigZag(nValue);
+    }
+    else
+    {
+      lpValues[nIndex] = (int32_t)nValue;
+    }
+  }
+
+  if (nKey)
+  {
+    Decoder.bHasKey = true;
+  }
+
+  return (bMissingKey ? TelemetryResult::MissingKey : TelemetryResult::Record);
+}
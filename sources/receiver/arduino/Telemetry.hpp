@@ -0,0 +1,78 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+#ifndef _TELEMETRY_HPP_
+#define _TELEMETRY_HPP_
+
+#include "Arduino.h"
+
+// Bit packed telemetry records decoder, see transmitter library
+// Telemetry.hpp. The schema must match the transmitter one.
+
+#define TELEMETRY_SIGNED 1
+#define TELEMETRY_DELTA  2
+#define TELEMETRY_VARINT 4
+
+struct TelemetryField
+{
+  uint8_t nBits;
+  uint8_t nFlags;
+};
+
+enum class TelemetryResult
+{
+  Record     = 0,
+  Done       = 1,
+  MissingKey = 2, // Delta record without a previous key one (frame lost)
+  Malformed  = 3
+};
+
+struct TelemetryDecoder
+{
+  const unsigned char* lpData;
+  unsigned int         nSize;
+  unsigned int         nBitIndex;
+  uint8_t              nRecords;
+  bool                 bHasKey;
+};
+
+/*
+ * No allocations: records are decoded straight from the GetMessage() buffer
+ * into lpValues (nFields items), which also holds the delta base, so keep
+ * it (and the decoder) alive across frames.
+ */
+
+void TelemetryInitialize(TelemetryDecoder& Decoder);
+
+void TelemetryBegin(
+  TelemetryDecoder&    Decoder,
+  const unsigned char* lpData,
+  unsigned int         nSize
+);
+
+TelemetryResult TelemetryNext(
+  TelemetryDecoder&     Decoder,
+  const TelemetryField* lpSchema,
+  uint8_t               nFields,
+  int32_t*              lpValues
+);
+
+#endif /* _TELEMETRY_HPP_ */
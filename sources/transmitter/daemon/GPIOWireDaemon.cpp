@@ -0,0 +1,1130 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include <algorithm>
+
+#include "GPIOWireDaemon.hpp"
+#include "Utils.hpp"
+
+// epoll data: client id and descriptor kind
+
+#define DAEMON_EVENT_LISTEN   0
+#define DAEMON_EVENT_WAKEUP   1
+#define DAEMON_EVENT_SOCKET   2
+#define DAEMON_EVENT_DOORBELL 3
+
+#define DAEMON_MAX_EVENTS     32
+#define DAEMON_MAX_FILES      1 // Ring memfd
+#define DAEMON_REPLY_FILES    2 // Doorbell and completion eventfds
+
+static uint64_t MakeEvent(uint64_t ulClient, unsigned int uiKind)
+{
+  return ((ulClient << 2) | uiKind);
+}
+
+/***********/
+/* SDevice */
+/***********/
+
+CGPIOWireDaemon::SDevice::SDevice(unsigned short uiNumber)
+  : uiNumber(uiNumber)
+  , GPIOWire(uiNumber)
+  , Session(GPIOWire.OpenSession())
+  , bStop(false)
+  , ulFrames(0)
+  , ulErrors(0)
+  , ulAirTime(0)
+{
+  // Air time (fairness) by the line code actually configured
+
+  GPIOWire.LoadConfiguration();
+}
+
+/*******************/
+/* CGPIOWireDaemon */
+/*******************/
+
+CGPIOWireDaemon::CGPIOWireDaemon(
+  const vector<unsigned short>& lpDevices,
+  const string&                 sSocket
+)
+  : m_sSocket(sSocket)
+  , m_iEpoll(-1)
+  , m_iListen(-1)
+  , m_iWakeup(-1)
+  , m_bStop(false)
+  , m_ulNextClient(1)
+{
+  for (size_t nIndex = 0; nIndex < lpDevices.size(); nIndex++)
+  {
+    m_lpDevices[lpDevices[nIndex]].reset(new SDevice(lpDevices[nIndex]));
+  }
+
+  m_lpPacket.resize(sizeof(SGPIOWireRequest) + DEF_GPIOWIRED_MAX_FRAME);
+}
+
+CGPIOWireDaemon::~CGPIOWireDaemon()
+{
+  for (auto& Entry : m_lpDevices)
+  {
+    SDevice& Device = *Entry.second;
+
+    {
+      lock_guard<mutex> Lock(Device.Mutex);
+
+      Device.bStop = true;
+    }
+
+    Device.Signal.notify_one();
+
+    if (Device.Writer.joinable())
+    {
+      Device.Writer.join();
+    }
+  }
+
+  while (!m_lpClients.empty())
+  {
+    Disconnect(m_lpClients.begin()->first);
+  }
+
+  if (-1 != m_iListen)
+  {
+    close(m_iListen);
+    unlink(m_sSocket.c_str());
+  }
+
+  if (-1 != m_iWakeup)
+  {
+    close(m_iWakeup);
+  }
+
+  if (-1 != m_iEpoll)
+  {
+    close(m_iEpoll);
+  }
+}
+
+bool CGPIOWireDaemon::Start()
+{
+  struct sockaddr_un Address = {};
+
+  if (m_sSocket.length() >= sizeof(Address.sun_path))
+  {
+    return false;
+  }
+
+  Address.sun_family = AF_UNIX;
+  strcpy(Address.sun_path, m_sSocket.c_str());
+
+  m_iEpoll  = epoll_create1(EPOLL_CLOEXEC);
+  m_iWakeup = eventfd(0, (EFD_CLOEXEC | EFD_NONBLOCK));
+  m_iListen = socket(AF_UNIX, (SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC), 0);
+
+  if ((-1 == m_iEpoll) || (-1 == m_iWakeup) || (-1 == m_iListen))
+  {
+    return false;
+  }
+
+  // Stale socket of a previous instance
+
+  unlink(m_sSocket.c_str());
+
+  if (
+       (-1 == bind(m_iListen, (struct sockaddr *)&Address, sizeof(Address)))
+    || (-1 == listen(m_iListen, SOMAXCONN))
+  )
+  {
+    close(m_iListen);
+    m_iListen = -1;
+
+    return false;
+  }
+
+  struct epoll_event Event = {};
+
+  Event.events   = EPOLLIN;
+  Event.data.u64 = MakeEvent(0, DAEMON_EVENT_LISTEN);
+
+  epoll_ctl(m_iEpoll, EPOLL_CTL_ADD, m_iListen, &Event);
+
+  Event.data.u64 = MakeEvent(0, DAEMON_EVENT_WAKEUP);
+
+  epoll_ctl(m_iEpoll, EPOLL_CTL_ADD, m_iWakeup, &Event);
+
+  for (auto& Entry : m_lpDevices)
+  {
+    SDevice& Device = *Entry.second;
+
+    Device.Writer = thread(&CGPIOWireDaemon::Write, this, ref(Device));
+  }
+
+  return true;
+}
+
+void CGPIOWireDaemon::Run()
+{
+  struct epoll_event lpEvents[DAEMON_MAX_EVENTS];
+
+  while (!m_bStop.load())
+  {
+    int iCount = epoll_wait(m_iEpoll, lpEvents, DAEMON_MAX_EVENTS, -1);
+
+    for (int iIndex = 0; iIndex < iCount; iIndex++)
+    {
+      uint64_t     ulClient = (lpEvents[iIndex].data.u64 >> 2);
+      unsigned int uiKind   = (lpEvents[iIndex].data.u64 & 3);
+      uint64_t     ulValue;
+
+      if (DAEMON_EVENT_LISTEN == uiKind)
+      {
+        Accept();
+        continue;
+      }
+
+      if (DAEMON_EVENT_WAKEUP == uiKind)
+      {
+        if (read(m_iWakeup, &ulValue, sizeof(ulValue))) {}
+
+        Complete();
+        continue;
+      }
+
+      // Disconnected by a previous event maybe
+
+      auto lpEntry = m_lpClients.find(ulClient);
+
+      if (m_lpClients.end() == lpEntry)
+      {
+        continue;
+      }
+
+      SClient& Client = *lpEntry->second;
+
+      if (DAEMON_EVENT_SOCKET == uiKind)
+      {
+        Receive(Client);
+      }
+      else
+      {
+        if (read(Client.iDoorbell, &ulValue, sizeof(ulValue))) {}
+
+        if (!DrainRing(Client))
+        {
+          Disconnect(ulClient);
+        }
+      }
+    }
+  }
+}
+
+void CGPIOWireDaemon::Stop()
+{
+  uint64_t ulValue = 1;
+
+  m_bStop.store(true);
+
+  if (write(m_iWakeup, &ulValue, sizeof(ulValue))) {}
+}
+
+void CGPIOWireDaemon::Accept()
+{
+  int iSocket;
+
+  while (-1 != (iSocket = accept4(m_iListen, NULL, NULL, (SOCK_NONBLOCK | SOCK_CLOEXEC))))
+  {
+    unique_ptr<SClient> lpClient(new SClient());
+
+    lpClient->ulId         = m_ulNextClient++;
+    lpClient->iSocket      = iSocket;
+    lpClient->iPid         = 0;
+    lpClient->nQueued      = 0;
+    lpClient->lpRing       = NULL;
+    lpClient->nRingMapSize = 0;
+    lpClient->ulRingSize   = 0;
+    lpClient->ulRingTail   = 0;
+    lpClient->iDoorbell    = -1;
+    lpClient->iCompletion  = -1;
+    lpClient->bNotify      = false;
+    lpClient->ulFrames     = 0;
+    lpClient->ulBytes      = 0;
+    lpClient->ulAirTime    = 0;
+    lpClient->ulErrors     = 0;
+    lpClient->ulRejected   = 0;
+
+    // Peer identity, for statistics
+
+    struct ucred Credentials;
+    socklen_t    nLength = sizeof(Credentials);
+
+    if (0 == getsockopt(iSocket, SOL_SOCKET, SO_PEERCRED, &Credentials, &nLength))
+    {
+      lpClient->iPid = Credentials.pid;
+
+      string sPath = CUtils::FormatString("/proc/%d/comm", (int)Credentials.pid);
+      FILE*  lpFile = fopen(sPath.c_str(), "r");
+      char   szName[64];
+
+      if (lpFile)
+      {
+        if (fgets(szName, sizeof(szName), lpFile))
+        {
+          lpClient->sName = szName;
+          lpClient->sName.erase(lpClient->sName.find_last_not_of("\n") + 1);
+        }
+
+        fclose(lpFile);
+      }
+    }
+
+    struct epoll_event Event = {};
+
+    Event.events   = EPOLLIN;
+    Event.data.u64 = MakeEvent(lpClient->ulId, DAEMON_EVENT_SOCKET);
+
+    epoll_ctl(m_iEpoll, EPOLL_CTL_ADD, iSocket, &Event);
+
+    m_lpClients[lpClient->ulId] = move(lpClient);
+  }
+}
+
+void CGPIOWireDaemon::Disconnect(uint64_t ulClient)
+{
+  auto lpEntry = m_lpClients.find(ulClient);
+
+  if (m_lpClients.end() == lpEntry)
+  {
+    return;
+  }
+
+  SClient& Client = *lpEntry->second;
+
+  // Queued frames are dropped, those being sent complete to nobody
+
+  for (auto& Entry : m_lpDevices)
+  {
+    SDevice&          Device = *Entry.second;
+    lock_guard<mutex> Lock(Device.Mutex);
+
+    for (unsigned int uiPriority = 0; uiPriority < DEF_GPIOWIRED_PRIORITIES; uiPriority++)
+    {
+      if (Device.lpQueues[uiPriority].erase(ulClient))
+      {
+        deque<uint64_t>& lpActive = Device.lpActive[uiPriority];
+
+        lpActive.erase(remove(lpActive.begin(), lpActive.end(), ulClient), lpActive.end());
+      }
+    }
+  }
+
+  if (Client.lpRing)
+  {
+    munmap(Client.lpRing, Client.nRingMapSize);
+  }
+
+  if (-1 != Client.iDoorbell)
+  {
+    close(Client.iDoorbell);
+  }
+
+  if (-1 != Client.iCompletion)
+  {
+    close(Client.iCompletion);
+  }
+
+  close(Client.iSocket);
+
+  m_lpClients.erase(lpEntry);
+}
+
+void CGPIOWireDaemon::Receive(SClient& Client)
+{
+  uint64_t ulClient = Client.ulId;
+
+  for (;;)
+  {
+    struct iovec  Part    = { m_lpPacket.data(), m_lpPacket.size() };
+    struct msghdr Message = {};
+
+    union
+    {
+      char           lpBuffer[CMSG_SPACE(DAEMON_MAX_FILES * sizeof(int))];
+      struct cmsghdr Align;
+    } Control;
+
+    Message.msg_iov        = &Part;
+    Message.msg_iovlen     = 1;
+    Message.msg_control    = Control.lpBuffer;
+    Message.msg_controllen = sizeof(Control.lpBuffer);
+
+    ssize_t nReceived = recvmsg(
+      Client.iSocket,
+      &Message,
+      (MSG_DONTWAIT | MSG_CMSG_CLOEXEC)
+    );
+
+    if (-1 == nReceived)
+    {
+      if ((EAGAIN != errno) && (EINTR != errno))
+      {
+        Disconnect(ulClient);
+      }
+
+      return;
+    }
+
+    // Descriptors, if any
+
+    int    lpFiles[DAEMON_MAX_FILES];
+    size_t nFiles = 0;
+
+    for (
+      struct cmsghdr* lpControl = CMSG_FIRSTHDR(&Message);
+      lpControl;
+      lpControl = CMSG_NXTHDR(&Message, lpControl)
+    )
+    {
+      if ((SOL_SOCKET != lpControl->cmsg_level) || (SCM_RIGHTS != lpControl->cmsg_type))
+      {
+        continue;
+      }
+
+      size_t nCount = ((lpControl->cmsg_len - CMSG_LEN(0)) / sizeof(int));
+      int*   lpData = (int *)CMSG_DATA(lpControl);
+
+      for (size_t nIndex = 0; nIndex < nCount; nIndex++)
+      {
+        if (nFiles < DAEMON_MAX_FILES)
+        {
+          lpFiles[nFiles++] = lpData[nIndex];
+        }
+        else
+        {
+          close(lpData[nIndex]);
+        }
+      }
+    }
+
+    SGPIOWireRequest Request;
+
+    if ((0 == nReceived) || (nReceived < (ssize_t)sizeof(Request)))
+    {
+      for (size_t nIndex = 0; nIndex < nFiles; nIndex++)
+      {
+        close(lpFiles[nIndex]);
+      }
+
+      // Hang up or protocol error
+
+      Disconnect(ulClient);
+      return;
+    }
+
+    memcpy(&Request, m_lpPacket.data(), sizeof(Request));
+
+    if (GPIOWIRE_REQUEST_ATTACH == Request.uiType)
+    {
+      Attach(Client, Request, lpFiles, nFiles);
+      continue;
+    }
+
+    for (size_t nIndex = 0; nIndex < nFiles; nIndex++)
+    {
+      close(lpFiles[nIndex]);
+    }
+
+    switch (Request.uiType)
+    {
+      case GPIOWIRE_REQUEST_SEND:
+      {
+        int iError = (
+            (MSG_TRUNC & Message.msg_flags)
+          ? EMSGSIZE
+          : Enqueue(
+              Client,
+              Request.uiDevice,
+              Request.uiPriority,
+              Request.uiSequence,
+              false,
+              (m_lpPacket.data() + sizeof(Request)),
+              (nReceived - sizeof(Request))
+            )
+        );
+
+        // Replied once sent otherwise
+
+        if (iError)
+        {
+          Reply(Client, Request.uiSequence, iError);
+        }
+
+        break;
+      }
+
+      case GPIOWIRE_REQUEST_STATISTICS:
+        Reply(Client, Request.uiSequence, 0, GetStatistics());
+        break;
+
+      default:
+        Reply(Client, Request.uiSequence, EINVAL);
+        break;
+    }
+  }
+}
+
+void CGPIOWireDaemon::Attach(
+  SClient&                Client,
+  const SGPIOWireRequest& Request,
+  const int*              lpFiles,
+  size_t                  nFiles
+)
+{
+  int iError = 0;
+
+  if (DAEMON_MAX_FILES != nFiles)
+  {
+    iError = EINVAL;
+  }
+  else if (Client.lpRing)
+  {
+    iError = EALREADY;
+  }
+
+  // The ring size cannot change under our feet (sealed memfd)
+
+  struct stat Stat;
+  size_t      nMapSize = 0;
+  uint64_t    ulSize   = 0;
+
+  if (!iError)
+  {
+    int iSeals = fcntl(lpFiles[0], F_GET_SEALS);
+
+    if (
+         (-1 == iSeals)
+      || !(iSeals & F_SEAL_SHRINK)
+      || (-1 == fstat(lpFiles[0], &Stat))
+      || (Stat.st_size <= (off_t)sizeof(SGPIOWireRing))
+    )
+    {
+      iError = EINVAL;
+    }
+    else
+    {
+      nMapSize = Stat.st_size;
+      ulSize   = (nMapSize - sizeof(SGPIOWireRing));
+
+      if ((ulSize < 4096) || (ulSize > 0x80000000) || (ulSize & (ulSize - 1)))
+      {
+        iError = EINVAL;
+      }
+    }
+  }
+
+  void* lpMap = MAP_FAILED;
+
+  if (!iError)
+  {
+    lpMap = mmap(NULL, nMapSize, (PROT_READ | PROT_WRITE), MAP_SHARED, lpFiles[0], 0);
+
+    if (MAP_FAILED == lpMap)
+    {
+      iError = errno;
+    }
+    else if (
+         (DEF_GPIOWIRED_RING_MAGIC != ((SGPIOWireRing *)lpMap)->uiMagic)
+      || (ulSize != ((SGPIOWireRing *)lpMap)->uiSize)
+    )
+    {
+      munmap(lpMap, nMapSize);
+
+      iError = EINVAL;
+    }
+  }
+
+  if (iError)
+  {
+    for (size_t nIndex = 0; nIndex < nFiles; nIndex++)
+    {
+      close(lpFiles[nIndex]);
+    }
+
+    Reply(Client, Request.uiSequence, iError);
+    return;
+  }
+
+  close(lpFiles[0]);
+
+  // Ours, non blocking: a client cannot stall the main loop with them
+
+  int lpEvents[DAEMON_REPLY_FILES] = {
+    eventfd(0, (EFD_CLOEXEC | EFD_NONBLOCK)),
+    eventfd(0, (EFD_CLOEXEC | EFD_NONBLOCK))
+  };
+
+  if ((-1 == lpEvents[0]) || (-1 == lpEvents[1]))
+  {
+    iError = errno;
+
+    for (size_t nIndex = 0; nIndex < DAEMON_REPLY_FILES; nIndex++)
+    {
+      if (-1 != lpEvents[nIndex])
+      {
+        close(lpEvents[nIndex]);
+      }
+    }
+
+    munmap(lpMap, nMapSize);
+
+    Reply(Client, Request.uiSequence, iError);
+    return;
+  }
+
+  Client.lpRing       = (SGPIOWireRing *)lpMap;
+  Client.nRingMapSize = nMapSize;
+  Client.ulRingSize   = ulSize;
+  Client.ulRingTail   = 0;
+  Client.iDoorbell    = lpEvents[0];
+  Client.iCompletion  = lpEvents[1];
+
+  struct epoll_event Event = {};
+
+  Event.events   = EPOLLIN;
+  Event.data.u64 = MakeEvent(Client.ulId, DAEMON_EVENT_DOORBELL);
+
+  epoll_ctl(m_iEpoll, EPOLL_CTL_ADD, Client.iDoorbell, &Event);
+
+  Reply(Client, Request.uiSequence, 0, "", lpEvents, DAEMON_REPLY_FILES);
+}
+
+bool CGPIOWireDaemon::DrainRing(SClient& Client)
+{
+  SGPIOWireRing* lpRing = Client.lpRing;
+
+  if (!lpRing)
+  {
+    return true;
+  }
+
+  // Everything in the ring is written by the client: check it all, and keep
+  // our own tail (the shared one is only published)
+
+  unsigned char* lpData = GetRingData(lpRing);
+  uint64_t&      ulTail = Client.ulRingTail;
+
+  for (;;)
+  {
+    uint64_t ulHead = lpRing->ulHead.load(memory_order_acquire);
+
+    while ((ulTail != ulHead) && (Client.nQueued < DEF_GPIOWIRED_MAX_QUEUED))
+    {
+      if ((ulTail > ulHead) || ((ulHead - ulTail) > Client.ulRingSize))
+      {
+        return false;
+      }
+
+      uint64_t            ulOffset = (ulTail & (Client.ulRingSize - 1));
+      SGPIOWireRingRecord Record;
+
+      if ((ulHead - ulTail) < sizeof(Record))
+      {
+        return false;
+      }
+
+      memcpy(&Record, (lpData + ulOffset), sizeof(Record));
+
+      if (GPIOWIRE_RING_SKIP == Record.uiSize)
+      {
+        if ((ulHead - ulTail) < (Client.ulRingSize - ulOffset))
+        {
+          return false;
+        }
+
+        ulTail += (Client.ulRingSize - ulOffset);
+        continue;
+      }
+
+      size_t nRecord = GetRingRecordSize(Record.uiSize);
+
+      if (
+           (Record.uiSize > DEF_GPIOWIRED_MAX_FRAME)
+        || ((ulOffset + nRecord) > Client.ulRingSize)
+        || ((ulHead - ulTail) < nRecord)
+      )
+      {
+        return false;
+      }
+
+      // Copied first, the client could still write to it
+
+      memcpy(m_lpPacket.data(), (lpData + ulOffset + sizeof(Record)), Record.uiSize);
+
+      ulTail += nRecord;
+
+      if (
+        Enqueue(
+          Client,
+          Record.uiDevice,
+          Record.uiPriority,
+          0,
+          true,
+          m_lpPacket.data(),
+          Record.uiSize
+        )
+      )
+      {
+        lpRing->ulFailed.fetch_add(1, memory_order_relaxed);
+        lpRing->ulCompleted.fetch_add(1, memory_order_release);
+
+        Client.bNotify = true;
+      }
+    }
+
+    lpRing->ulTail.store(ulTail, memory_order_release);
+
+    // Full client queue: drained again on completions
+
+    if (ulTail != ulHead)
+    {
+      return true;
+    }
+
+    // Idle: ask for the doorbell, unless a frame raced in
+
+    lpRing->uiWaiting.store(1, memory_order_seq_cst);
+
+    if (lpRing->ulHead.load(memory_order_seq_cst) == ulTail)
+    {
+      return true;
+    }
+
+    lpRing->uiWaiting.store(0, memory_order_relaxed);
+  }
+}
+
+void CGPIOWireDaemon::Complete()
+{
+  {
+    lock_guard<mutex> Lock(m_CompletionsMutex);
+
+    m_lpPending.swap(m_lpCompletions);
+  }
+
+  for (size_t nIndex = 0; nIndex < m_lpPending.size(); nIndex++)
+  {
+    const SCompletion& Completion = m_lpPending[nIndex];
+
+    auto lpEntry = m_lpClients.find(Completion.ulClient);
+
+    if (m_lpClients.end() == lpEntry)
+    {
+      continue;
+    }
+
+    SClient& Client = *lpEntry->second;
+
+    Client.nQueued--;
+
+    if (Completion.iError)
+    {
+      Client.ulErrors++;
+    }
+    else
+    {
+      Client.ulFrames++;
+      Client.ulBytes   += Completion.nSize;
+      Client.ulAirTime += Completion.ulAirTime;
+    }
+
+    if (Completion.bRing)
+    {
+      if (Completion.iError)
+      {
+        Client.lpRing->ulFailed.fetch_add(1, memory_order_relaxed);
+      }
+
+      Client.lpRing->ulCompleted.fetch_add(1, memory_order_release);
+      Client.bNotify = true;
+    }
+    else
+    {
+      Reply(Client, Completion.uiSequence, Completion.iError);
+    }
+  }
+
+  m_lpPending.clear();
+
+  // Wake flushing clients up, and resume rings stopped by a full queue
+
+  vector<uint64_t> lpBroken;
+
+  for (auto& Entry : m_lpClients)
+  {
+    SClient& Client = *Entry.second;
+
+    if (!Client.lpRing)
+    {
+      continue;
+    }
+
+    if (!DrainRing(Client))
+    {
+      lpBroken.push_back(Client.ulId);
+      continue;
+    }
+
+    if (Client.bNotify)
+    {
+      uint64_t ulValue = 1;
+
+      if (write(Client.iCompletion, &ulValue, sizeof(ulValue))) {}
+
+      Client.bNotify = false;
+    }
+  }
+
+  for (size_t nIndex = 0; nIndex < lpBroken.size(); nIndex++)
+  {
+    Disconnect(lpBroken[nIndex]);
+  }
+}
+
+int CGPIOWireDaemon::Enqueue(
+  SClient&             Client,
+  uint16_t             uiDevice,
+  unsigned int         uiPriority,
+  uint32_t             uiSequence,
+  bool                 bRing,
+  const unsigned char* lpMessage,
+  size_t               nSize
+)
+{
+  auto lpEntry = m_lpDevices.find(uiDevice);
+
+  if (m_lpDevices.end() == lpEntry)
+  {
+    Client.ulErrors++;
+    return ENODEV;
+  }
+
+  if (uiPriority >= DEF_GPIOWIRED_PRIORITIES)
+  {
+    Client.ulErrors++;
+    return EINVAL;
+  }
+
+  if (Client.nQueued >= DEF_GPIOWIRED_MAX_QUEUED)
+  {
+    Client.ulRejected++;
+    return EAGAIN;
+  }
+
+  SDevice& Device = *lpEntry->second;
+  SFrame   Frame;
+
+  Frame.ulClient   = Client.ulId;
+  Frame.uiSequence = uiSequence;
+  Frame.bRing      = bRing;
+  Frame.ulAirTime  = Device.GPIOWire.GetAirTime(lpMessage, nSize);
+
+  Frame.lpMessage.assign(lpMessage, (lpMessage + nSize));
+
+  {
+    lock_guard<mutex> Lock(Device.Mutex);
+
+    SClientQueue& Queue = Device.lpQueues[uiPriority][Client.ulId];
+
+    if (Queue.lpFrames.empty())
+    {
+      Queue.lDeficit = 0;
+
+      Device.lpActive[uiPriority].push_back(Client.ulId);
+    }
+
+    Queue.lpFrames.push_back(move(Frame));
+  }
+
+  Device.Signal.notify_one();
+
+  Client.nQueued++;
+
+  return 0;
+}
+
+void CGPIOWireDaemon::Reply(
+  SClient&      Client,
+  uint32_t      uiSequence,
+  int           iError,
+  const string& sText,
+  const int*    lpFiles,
+  size_t        nFiles
+)
+{
+  assert(nFiles <= DAEMON_REPLY_FILES);
+
+  SGPIOWireReply Reply = { uiSequence, iError };
+
+  struct iovec lpParts[2] = {
+    { &Reply,                sizeof(Reply)  },
+    { (void *)sText.data(),  sText.length() }
+  };
+
+  struct msghdr Message = {};
+
+  Message.msg_iov    = lpParts;
+  Message.msg_iovlen = (sText.empty() ? 1 : 2);
+
+  // Descriptors passing (duplicated by the kernel, ours are kept)
+
+  union
+  {
+    char           lpBuffer[CMSG_SPACE(DAEMON_REPLY_FILES * sizeof(int))];
+    struct cmsghdr Align;
+  } Control;
+
+  if (nFiles)
+  {
+    Message.msg_control    = Control.lpBuffer;
+    Message.msg_controllen = CMSG_SPACE(nFiles * sizeof(int));
+
+    struct cmsghdr* lpControl = CMSG_FIRSTHDR(&Message);
+
+    lpControl->cmsg_level = SOL_SOCKET;
+    lpControl->cmsg_type  = SCM_RIGHTS;
+    lpControl->cmsg_len   = CMSG_LEN(nFiles * sizeof(int));
+
+    memcpy(CMSG_DATA(lpControl), lpFiles, (nFiles * sizeof(int)));
+  }
+
+  // A client not reading its replies loses them
+
+  sendmsg(Client.iSocket, &Message, (MSG_DONTWAIT | MSG_NOSIGNAL));
+}
+
+string CGPIOWireDaemon::GetStatistics()
+{
+  string sText;
+
+  for (auto& Entry : m_lpDevices)
+  {
+    SDevice&          Device = *Entry.second;
+    lock_guard<mutex> Lock(Device.Mutex);
+    size_t            nQueued = 0;
+
+    for (unsigned int uiPriority = 0; uiPriority < DEF_GPIOWIRED_PRIORITIES; uiPriority++)
+    {
+      for (auto& Queue : Device.lpQueues[uiPriority])
+      {
+        nQueued += Queue.second.lpFrames.size();
+      }
+    }
+
+    sText += CUtils::FormatString(
+      "device %u: frames %llu, errors %llu, air time %llu mS, queued %zu\n",
+      Device.uiNumber,
+      (unsigned long long)Device.ulFrames,
+      (unsigned long long)Device.ulErrors,
+      (unsigned long long)(Device.ulAirTime / 1000),
+      nQueued
+    );
+  }
+
+  for (auto& Entry : m_lpClients)
+  {
+    SClient& Client = *Entry.second;
+
+    sText += CUtils::FormatString(
+      "client %llu (%s, pid %d): frames %llu, bytes %llu, air time %llu mS, "
+      "errors %llu, rejected %llu, queued %zu%s\n",
+      (unsigned long long)Client.ulId,
+      Client.sName.c_str(),
+      (int)Client.iPid,
+      (unsigned long long)Client.ulFrames,
+      (unsigned long long)Client.ulBytes,
+      (unsigned long long)(Client.ulAirTime / 1000),
+      (unsigned long long)Client.ulErrors,
+      (unsigned long long)Client.ulRejected,
+      Client.nQueued,
+      (Client.lpRing ? ", ring" : "")
+    );
+  }
+
+  return sText;
+}
+
+void CGPIOWireDaemon::Write(SDevice& Device)
+{
+  vector<SFrame>               lpBurst;
+  vector<const unsigned char*> lpMessages;
+  vector<size_t>               lpSizes;
+  vector<SCompletion>          lpCompletions;
+  unique_lock<mutex>           Lock(Device.Mutex);
+
+  for (;;)
+  {
+    // Highest priority with queued frames
+
+    int iPriority = -1;
+
+    for (int iLevel = (DEF_GPIOWIRED_PRIORITIES - 1); iLevel >= 0; iLevel--)
+    {
+      if (!Device.lpActive[iLevel].empty())
+      {
+        iPriority = iLevel;
+        break;
+      }
+    }
+
+    if (Device.bStop)
+    {
+      break;
+    }
+
+    if (-1 == iPriority)
+    {
+      Device.Signal.wait(Lock);
+      continue;
+    }
+
+    // Deficit round robin by air time: a client is served while its deficit
+    // is positive, then it goes last with a new quantum
+
+    map<uint64_t, SClientQueue>& lpQueues = Device.lpQueues[iPriority];
+    deque<uint64_t>&             lpActive = Device.lpActive[iPriority];
+
+    while ((lpBurst.size() < DEF_GPIOWIRED_MAX_BURST) && !lpActive.empty())
+    {
+      uint64_t      ulClient = lpActive.front();
+      SClientQueue& Queue    = lpQueues[ulClient];
+
+      if (Queue.lDeficit <= 0)
+      {
+        Queue.lDeficit += DEF_GPIOWIRED_QUANTUM;
+
+        lpActive.pop_front();
+        lpActive.push_back(ulClient);
+        continue;
+      }
+
+      Queue.lDeficit -= Queue.lpFrames.front().ulAirTime;
+
+      lpBurst.push_back(move(Queue.lpFrames.front()));
+      Queue.lpFrames.pop_front();
+
+      if (Queue.lpFrames.empty())
+      {
+        lpActive.pop_front();
+        lpQueues.erase(ulClient);
+      }
+    }
+
+    Lock.unlock();
+
+    for (size_t nIndex = 0; nIndex < lpBurst.size(); nIndex++)
+    {
+      lpMessages.push_back(lpBurst[nIndex].lpMessage.data());
+      lpSizes.push_back(lpBurst[nIndex].lpMessage.size());
+    }
+
+    if (!Device.Session.IsOpen())
+    {
+      Device.Session.Reconnect();
+    }
+
+    SGPIOWireResult Result = Device.Session.SendMessages(
+      lpMessages.data(),
+      lpSizes.data(),
+      lpBurst.size()
+    );
+
+    // Reopen the device on next burst after a failure
+
+    if (!Result && (EINTR != Result.iError))
+    {
+      Device.Session.Close();
+    }
+
+    uint64_t ulAirTime = 0;
+
+    for (size_t nIndex = 0; nIndex < lpBurst.size(); nIndex++)
+    {
+      const SFrame& Frame  = lpBurst[nIndex];
+      int           iError = 0;
+
+      if (nIndex >= Result.nFrames)
+      {
+        iError = (Result.iError ? Result.iError : EINTR);
+      }
+      else
+      {
+        ulAirTime += Frame.ulAirTime;
+      }
+
+      lpCompletions.push_back(
+        {
+          Frame.ulClient,
+          Frame.uiSequence,
+          Frame.bRing,
+          iError,
+          Frame.lpMessage.size(),
+          Frame.ulAirTime
+        }
+      );
+    }
+
+    {
+      lock_guard<mutex> CompletionsLock(m_CompletionsMutex);
+
+      m_lpCompletions.insert(
+        m_lpCompletions.end(),
+        lpCompletions.begin(),
+        lpCompletions.end()
+      );
+    }
+
+    uint64_t ulValue = 1;
+
+    if (write(m_iWakeup, &ulValue, sizeof(ulValue))) {}
+
+    Lock.lock();
+
+    Device.ulFrames  += Result.nFrames;
+    Device.ulErrors  += (lpBurst.size() - Result.nFrames);
+    Device.ulAirTime += ulAirTime;
+
+    lpBurst.clear();
+    lpMessages.clear();
+    lpSizes.clear();
+    lpCompletions.clear();
+  }
+}
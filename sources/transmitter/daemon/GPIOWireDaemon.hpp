@@ -0,0 +1,197 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef _GPIO_WIRE_DAEMON_HPP_
+#define _GPIO_WIRE_DAEMON_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "GPIOWire.hpp"
+#include "GPIOWireProtocol.hpp"
+#include "GPIOWireSession.hpp"
+
+using namespace std;
+
+#define DEF_GPIOWIRED_MAX_QUEUED 256    // Frames per client
+#define DEF_GPIOWIRED_MAX_BURST  16     // Frames per vectored write
+#define DEF_GPIOWIRED_QUANTUM    100000 // uS of air time per round
+
+// Owns every device and multiplexes local clients onto them: requests come
+// from the Unix socket or from the clients shared memory rings (main
+// thread, epoll), frames are queued per device, priority and client, and
+// each device writer thread sends bursts of them, strict priority first,
+// then deficit round robin by air time across the clients of a priority
+// (fair queueing).
+
+class CGPIOWireDaemon
+{
+public:
+  CGPIOWireDaemon(
+    const vector<unsigned short>& lpDevices,
+    const string&                 sSocket = DEF_GPIOWIRED_SOCKET
+  );
+
+  ~CGPIOWireDaemon();
+
+  CGPIOWireDaemon(const CGPIOWireDaemon&)            = delete;
+  CGPIOWireDaemon& operator=(const CGPIOWireDaemon&) = delete;
+
+  bool Start();
+  void Run();
+
+  // Async signal safe.
+
+  void Stop();
+
+private:
+  struct SFrame
+  {
+    uint64_t              ulClient;
+    uint32_t              uiSequence;
+    bool                  bRing;
+    unsigned long         ulAirTime;
+    vector<unsigned char> lpMessage;
+  };
+
+  struct SClientQueue
+  {
+    deque<SFrame> lpFrames;
+    int64_t       lDeficit;
+  };
+
+  struct SDevice
+  {
+    unsigned short               uiNumber;
+    CGPIOWire                    GPIOWire;
+    CGPIOWireSession             Session;
+
+    mutex                        Mutex;
+    condition_variable           Signal;
+    map<uint64_t, SClientQueue>  lpQueues[DEF_GPIOWIRED_PRIORITIES];
+    deque<uint64_t>              lpActive[DEF_GPIOWIRED_PRIORITIES];
+    bool                         bStop;
+
+    uint64_t                     ulFrames;  // Under Mutex
+    uint64_t                     ulErrors;
+    uint64_t                     ulAirTime;
+
+    thread                       Writer;
+
+    explicit SDevice(unsigned short uiNumber);
+  };
+
+  struct SClient
+  {
+    uint64_t       ulId;
+    int            iSocket;
+    pid_t          iPid;
+    string         sName;
+    size_t         nQueued;
+
+    SGPIOWireRing* lpRing;
+    size_t         nRingMapSize;
+    uint64_t       ulRingSize;
+    uint64_t       ulRingTail;   // Never read back from the ring
+    int            iDoorbell;
+    int            iCompletion;
+    bool           bNotify;
+
+    uint64_t       ulFrames;
+    uint64_t       ulBytes;
+    uint64_t       ulAirTime;
+    uint64_t       ulErrors;
+    uint64_t       ulRejected;
+  };
+
+  struct SCompletion
+  {
+    uint64_t      ulClient;
+    uint32_t      uiSequence;
+    bool          bRing;
+    int           iError;
+    size_t        nSize;
+    unsigned long ulAirTime;
+  };
+
+  string                           m_sSocket;
+  int                              m_iEpoll;
+  int                              m_iListen;
+  int                              m_iWakeup;
+  atomic<bool>                     m_bStop;
+
+  map<unsigned short, unique_ptr<SDevice>> m_lpDevices;
+  map<uint64_t, unique_ptr<SClient>>       m_lpClients;
+  uint64_t                                 m_ulNextClient;
+
+  mutex                            m_CompletionsMutex;
+  vector<SCompletion>              m_lpCompletions;
+  vector<SCompletion>              m_lpPending;
+
+  vector<unsigned char>            m_lpPacket;
+
+  void Accept();
+  void Disconnect(uint64_t ulClient);
+  void Receive(SClient& Client);
+  void Attach(
+    SClient&                Client,
+    const SGPIOWireRequest& Request,
+    const int*              lpFiles,
+    size_t                  nFiles
+  );
+  bool DrainRing(SClient& Client);
+  void Complete();
+
+  int  Enqueue(
+    SClient&             Client,
+    uint16_t             uiDevice,
+    unsigned int         uiPriority,
+    uint32_t             uiSequence,
+    bool                 bRing,
+    const unsigned char* lpMessage,
+    size_t               nSize
+  );
+
+  void Reply(
+    SClient&      Client,
+    uint32_t      uiSequence,
+    int           iError,
+    const string& sText   = "",
+    const int*    lpFiles = NULL,
+    size_t        nFiles  = 0
+  );
+
+  string GetStatistics();
+
+  void Write(SDevice& Device);
+};
+
+#endif /* _GPIO_WIRE_DAEMON_HPP_ */
@@ -0,0 +1,125 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "GPIOWireClient.hpp"
+#include "GPIOWireDaemon.hpp"
+#include "GPIOWirePool.hpp"
+
+static CGPIOWireDaemon* g_lpDaemon = NULL;
+
+static void OnSignal(int iSignal)
+{
+  if (g_lpDaemon)
+  {
+    g_lpDaemon->Stop();
+  }
+}
+
+static int Usage()
+{
+  fprintf(
+    stderr,
+    "Usage: gpiowired [-s socket] [-d device]... [--stats]\n"
+    "  -s socket  Unix socket path (default " DEF_GPIOWIRED_SOCKET ")\n"
+    "  -d device  device number to own (default all of them)\n"
+    "  --stats    print the statistics of the running daemon\n"
+  );
+
+  return 1;
+}
+
+int main(int argc, char *argv[])
+{
+  string                 sSocket = DEF_GPIOWIRED_SOCKET;
+  vector<unsigned short> lpDevices;
+  bool                   bStatistics = false;
+
+  for (int iIndex = 1; iIndex < argc; iIndex++)
+  {
+    if (!strcmp(argv[iIndex], "-s") && ((iIndex + 1) < argc))
+    {
+      sSocket = argv[++iIndex];
+    }
+    else if (!strcmp(argv[iIndex], "-d") && ((iIndex + 1) < argc))
+    {
+      lpDevices.push_back((unsigned short)atoi(argv[++iIndex]));
+    }
+    else if (!strcmp(argv[iIndex], "--stats"))
+    {
+      bStatistics = true;
+    }
+    else
+    {
+      return Usage();
+    }
+  }
+
+  if (bStatistics)
+  {
+    CGPIOWireClient Client(0, sSocket);
+
+    if (!Client.Exists())
+    {
+      fprintf(stderr, "%s\n", Client.GetLastResult().GetDescription().c_str());
+      return 1;
+    }
+
+    fputs(Client.GetStatistics().c_str(), stdout);
+
+    return 0;
+  }
+
+  if (lpDevices.empty())
+  {
+    lpDevices = CGPIOWirePool::Discover();
+
+    if (lpDevices.empty())
+    {
+      fprintf(stderr, "No gpiowire device found.\n");
+      return 1;
+    }
+  }
+
+  CGPIOWireDaemon Daemon(lpDevices, sSocket);
+
+  if (!Daemon.Start())
+  {
+    fprintf(stderr, "Cannot listen on %s: %s\n", sSocket.c_str(), strerror(errno));
+    return 1;
+  }
+
+  g_lpDaemon = &Daemon;
+
+  signal(SIGINT, OnSignal);
+  signal(SIGTERM, OnSignal);
+  signal(SIGPIPE, SIG_IGN);
+
+  Daemon.Run();
+
+  g_lpDaemon = NULL;
+
+  return 0;
+}
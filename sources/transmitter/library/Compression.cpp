@@ -0,0 +1,160 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <assert.h>
+#include <string.h>
+
+#include "Compression.hpp"
+#include "Dictionary.hpp"
+
+static const char     m_lpDictionaryData[]    = DICTIONARY_DATA;
+static const uint16_t m_lpDictionaryOffsets[] = { DICTIONARY_OFFSETS };
+
+size_t CCompression::GetMaxCompressedSize(size_t nSize)
+{
+  return (nSize * 2); // Every byte escaped
+}
+
+size_t CCompression::Compress(
+  const unsigned char* lpData,
+  size_t               nSize,
+  unsigned char*       lpCompressed
+)
+{
+  assert(lpData);
+  assert(lpCompressed);
+
+  size_t nIndex          = 0;
+  size_t nCompressedSize = 0;
+
+  while (nIndex < nSize)
+  {
+    // Greedy longest match
+
+    size_t nBestEntry = DICTIONARY_ENTRY_COUNT;
+    size_t nBestSize  = 1;
+
+    for (size_t nEntry = 0; nEntry < DICTIONARY_ENTRY_COUNT; nEntry++)
+    {
+      size_t nEntrySize = (
+          m_lpDictionaryOffsets[nEntry + 1]
+        - m_lpDictionaryOffsets[nEntry]
+      );
+
+      if (
+           (nEntrySize > nBestSize)
+        && (nEntrySize <= (nSize - nIndex))
+        && (0 == memcmp(
+             (lpData + nIndex),
+             (m_lpDictionaryData + m_lpDictionaryOffsets[nEntry]),
+             nEntrySize
+           ))
+      )
+      {
+        nBestEntry = nEntry;
+        nBestSize  = nEntrySize;
+      }
+    }
+
+    if (nBestEntry < DICTIONARY_ENTRY_COUNT)
+    {
+      lpCompressed[nCompressedSize++] = (COMPRESSION_ENTRY_BASE + nBestEntry);
+    }
+    else
+    {
+      if (lpData[nIndex] >= COMPRESSION_ENTRY_BASE)
+      {
+        lpCompressed[nCompressedSize++] = COMPRESSION_ESCAPE;
+      }
+
+      lpCompressed[nCompressedSize++] = lpData[nIndex];
+    }
+
+    nIndex += nBestSize;
+  }
+
+  return nCompressedSize;
+}
+
+size_t CCompression::Decompress(
+  const unsigned char* lpCompressed,
+  size_t               nSize,
+  unsigned char*       lpData,
+  size_t               nMaxSize
+)
+{
+  assert(lpCompressed);
+  assert(lpData);
+
+  size_t nDataSize = 0;
+
+  for (size_t nIndex = 0; nIndex < nSize; nIndex++)
+  {
+    unsigned char cCode = lpCompressed[nIndex];
+
+    if (cCode < COMPRESSION_ENTRY_BASE)
+    {
+      if (nDataSize >= nMaxSize)
+      {
+        return (size_t)-1;
+      }
+
+      lpData[nDataSize++] = cCode;
+    }
+    else if (COMPRESSION_ESCAPE == cCode)
+    {
+      if ((++nIndex >= nSize) || (nDataSize >= nMaxSize))
+      {
+        return (size_t)-1;
+      }
+
+      lpData[nDataSize++] = lpCompressed[nIndex];
+    }
+    else
+    {
+      size_t nEntry = (cCode - COMPRESSION_ENTRY_BASE);
+
+      if (nEntry >= DICTIONARY_ENTRY_COUNT)
+      {
+        return (size_t)-1;
+      }
+
+      size_t nEntrySize = (
+          m_lpDictionaryOffsets[nEntry + 1]
+        - m_lpDictionaryOffsets[nEntry]
+      );
+
+      if ((nDataSize + nEntrySize) > nMaxSize)
+      {
+        return (size_t)-1;
+      }
+
+      memcpy(
+        (lpData + nDataSize),
+        (m_lpDictionaryData + m_lpDictionaryOffsets[nEntry]),
+        nEntrySize
+      );
+
+      nDataSize += nEntrySize;
+    }
+  }
+
+  return nDataSize;
+}
@@ -0,0 +1,59 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef _COMPRESSION_HPP_
+#define _COMPRESSION_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Static dictionary compression.
+//
+// The dictionary (Dictionary.hpp) is pre-shared with the receiver and built
+// from a message corpus by the "gpiowire-dictionary" tool. Bytes below 0x80
+// are literals, 0x80 + N refers to dictionary entry N and 0xFF escapes the
+// following byte (a literal above 0x7F): compressed text never contains
+// bytes which were not already in the payload or above 0x7F.
+
+#define COMPRESSION_ENTRY_BASE 0x80
+#define COMPRESSION_ESCAPE     0xFF
+
+class CCompression
+{
+public:
+  static size_t GetMaxCompressedSize(size_t nSize);
+
+  static size_t Compress(
+    const unsigned char* lpData,
+    size_t               nSize,
+    unsigned char*       lpCompressed
+  );
+
+  // Returns the decompressed size, or (size_t)-1 on overflow/bad data.
+
+  static size_t Decompress(
+    const unsigned char* lpCompressed,
+    size_t               nSize,
+    unsigned char*       lpData,
+    size_t               nMaxSize
+  );
+};
+
+#endif /* _COMPRESSION_HPP_ */
@@ -0,0 +1,198 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <assert.h>
+
+#include "FEC.hpp"
+
+// Codeword bit positions (1..7): p1 p2 d1 p3 d2 d3 d4
+
+static uint8_t HammingEncode(uint8_t nNibble)
+{
+  uint8_t d1 = (nNibble >> 3) & 1;
+  uint8_t d2 = (nNibble >> 2) & 1;
+  uint8_t d3 = (nNibble >> 1) & 1;
+  uint8_t d4 =  nNibble       & 1;
+
+  uint8_t p1 = d1 ^ d2 ^ d4;
+  uint8_t p2 = d1 ^ d3 ^ d4;
+  uint8_t p3 = d2 ^ d3 ^ d4;
+
+  return
+      (p1 << 0)
+    | (p2 << 1)
+    | (d1 << 2)
+    | (p3 << 3)
+    | (d2 << 4)
+    | (d3 << 5)
+    | (d4 << 6)
+  ;
+}
+
+static uint8_t HammingDecode(uint8_t nCodeword, unsigned int& uiCorrected)
+{
+  uint8_t nSyndrome =
+      (((nCodeword >> 0) ^ (nCodeword >> 2) ^ (nCodeword >> 4) ^ (nCodeword >> 6)) & 1)
+    | ((((nCodeword >> 1) ^ (nCodeword >> 2) ^ (nCodeword >> 5) ^ (nCodeword >> 6)) & 1) << 1)
+    | ((((nCodeword >> 3) ^ (nCodeword >> 4) ^ (nCodeword >> 5) ^ (nCodeword >> 6)) & 1) << 2)
+  ;
+
+  if (nSyndrome)
+  {
+    // Syndrome is the (1 based) position of the flipped bit
+
+    nCodeword ^= (1 << (nSyndrome - 1));
+    uiCorrected++;
+  }
+
+  return
+      (((nCodeword >> 2) & 1) << 3)
+    | (((nCodeword >> 4) & 1) << 2)
+    | (((nCodeword >> 5) & 1) << 1)
+    |  ((nCodeword >> 6) & 1)
+  ;
+}
+
+size_t CFEC::GetEncodedSize(size_t nSize)
+{
+  size_t nNibbles = (1 /* Padding count */ + (nSize * 2));
+
+  return (((nNibbles + FEC_BLOCK_SIZE - 1) / FEC_BLOCK_SIZE) * FEC_BLOCK_SIZE);
+}
+
+size_t CFEC::Encode(
+  const unsigned char* lpData,
+  size_t               nSize,
+  unsigned char*       lpEncoded
+)
+{
+  assert(lpData);
+  assert(lpEncoded);
+
+  size_t  nEncodedSize = GetEncodedSize(nSize);
+  uint8_t nPadding     = (nEncodedSize - 1 - (nSize * 2));
+  uint8_t lpCodewords[FEC_BLOCK_SIZE];
+
+  for (size_t nBlock = 0; nBlock < nEncodedSize; nBlock += FEC_BLOCK_SIZE)
+  {
+    // Encode block nibbles
+
+    for (size_t nIndex = 0; nIndex < FEC_BLOCK_SIZE; nIndex++)
+    {
+      size_t  nNibble = (nBlock + nIndex);
+      uint8_t nValue  = 0;
+
+      if (0 == nNibble)
+      {
+        nValue = nPadding;
+      }
+      else if (nNibble <= (nSize * 2))
+      {
+        uint8_t nByte = lpData[(nNibble - 1) / 2];
+
+        nValue = ((nNibble & 1) ? (nByte >> 4) : (nByte & 0x0F));
+      }
+
+      lpCodewords[nIndex] = HammingEncode(nValue);
+    }
+
+    // Interleave
+
+    for (size_t nBit = 0; nBit < FEC_BLOCK_SIZE; nBit++)
+    {
+      uint8_t nByte = 0x80; // Marker bit
+
+      for (size_t nIndex = 0; nIndex < FEC_BLOCK_SIZE; nIndex++)
+      {
+        nByte |= (((lpCodewords[nIndex] >> nBit) & 1) << nIndex);
+      }
+
+      lpEncoded[nBlock + nBit] = nByte;
+    }
+  }
+
+  return nEncodedSize;
+}
+
+bool CFEC::Decode(
+  unsigned char* lpData,
+  size_t&        nSize,
+  unsigned int&  uiCorrected
+)
+{
+  assert(lpData);
+
+  uiCorrected = 0;
+
+  if ((0 == nSize) || (0 != (nSize % FEC_BLOCK_SIZE)))
+  {
+    return false;
+  }
+
+  uint8_t nPadding = 0;
+  uint8_t lpCodewords[FEC_BLOCK_SIZE];
+
+  for (size_t nBlock = 0; nBlock < nSize; nBlock += FEC_BLOCK_SIZE)
+  {
+    // De-interleave (the whole block is read before writing back, so
+    // decoded data never overwrites unread input)
+
+    for (size_t nIndex = 0; nIndex < FEC_BLOCK_SIZE; nIndex++)
+    {
+      lpCodewords[nIndex] = 0;
+
+      for (size_t nBit = 0; nBit < FEC_BLOCK_SIZE; nBit++)
+      {
+        lpCodewords[nIndex] |= (((lpData[nBlock + nBit] >> nIndex) & 1) << nBit);
+      }
+    }
+
+    for (size_t nIndex = 0; nIndex < FEC_BLOCK_SIZE; nIndex++)
+    {
+      size_t  nNibble = (nBlock + nIndex);
+      uint8_t nValue  = HammingDecode(lpCodewords[nIndex], uiCorrected);
+
+      if (0 == nNibble)
+      {
+        nPadding = nValue;
+      }
+      else if (nNibble & 1)
+      {
+        lpData[(nNibble - 1) / 2] = (nValue << 4);
+      }
+      else
+      {
+        lpData[(nNibble - 1) / 2] |= nValue;
+      }
+    }
+  }
+
+  if (
+       (nPadding >= FEC_BLOCK_SIZE)
+    || (0 != ((nSize - 1 - nPadding) % 2))
+  )
+  {
+    return false;
+  }
+
+  nSize = ((nSize - 1 - nPadding) / 2);
+
+  return true;
+}
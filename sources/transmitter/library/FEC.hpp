@@ -0,0 +1,57 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef _FEC_HPP_
+#define _FEC_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Interleaved Hamming(7,4) forward error correction.
+//
+// Data is split into nibbles, prefixed by a padding count nibble and padded
+// to blocks of 7 codewords. Each block is transposed into 7 bytes (bit i of
+// byte j is bit j of codeword i), so a whole corrupted byte costs a single
+// correctable bit per codeword. The spare MSB of each byte is always set:
+// encoded data can never collide with STX/ETX sentinels.
+
+#define FEC_BLOCK_SIZE 7
+
+class CFEC
+{
+public:
+  static size_t GetEncodedSize(size_t nSize);
+
+  static size_t Encode(
+    const unsigned char* lpData,
+    size_t               nSize,
+    unsigned char*       lpEncoded
+  );
+
+  // Decodes in place, returns false on malformed data.
+
+  static bool   Decode(
+    unsigned char* lpData,
+    size_t&        nSize,
+    unsigned int&  uiCorrected
+  );
+};
+
+#endif /* _FEC_HPP_ */
@@ -23,12 +23,34 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <string.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <vector>
 
 #include "GPIOWire.hpp"
 
 CGPIOWire::CGPIOWire(unsigned short uiDeviceNumber)
   : m_sDevice(CUtils::FormatString("/dev/gpiowire%d", uiDeviceNumber))
+  , m_sSysClass(CUtils::FormatString(
+      "/sys/class/gpiowires/gpiowire%d",
+      uiDeviceNumber
+    ))
   , m_uiDeviceNumber(uiDeviceNumber)
+  , m_cETX(DEF_GPIO_ENCODER_ETX)
+  , m_cSTX(DEF_GPIO_ENCODER_STX)
+  , m_bFEC(false)
+  , m_bCompression(false)
+  , m_bLengthPrefix(false)
+  , m_bAddressing(false)
+  , m_cAddress(DEF_GPIO_ENCODER_BROADCAST)
+
+  , m_nBatchMaxPayload(0)
+  , m_ulBatchMaxDelay(0)
+  , m_bBatchCRC(false)
+  , m_ulBatchStart(0)
+
+  , m_nFragmentMTU(0)
 {
   assert(uiDeviceNumber >= 0);
 }
@@ -49,62 +71,287 @@ bool CGPIOWire::Configure(
   m_cETX = cETX;
   m_cSTX = cSTX;
 
-  string sSysClass(CUtils::FormatString(
-    "/sys/class/gpiowires/gpiowire%d",
-    m_uiDeviceNumber)
-  );
+  m_LineCode.ulSyncBitCount    = ulSyncBitCount;
+  m_LineCode.ulHighStateEdge   = ulHighStateEdge;
+  m_LineCode.ulBitZeroDuration = ulBitZeroDuration;
+  m_LineCode.ulBitOneDuration  = ulBitOneDuration;
+  m_LineCode.ulBitSyncDuration = ulBitSyncDuration;
+
+  return
+       SetParameter(m_sSysClass, "pinNumber",       ulPinNumber)
+    && SetParameter(m_sSysClass, "canSleep",        bCanSleep)
+    && SetParameter(m_sSysClass, "swapOutput",      bSwapOutput)
+    && SetParameter(m_sSysClass, "bitSyncCount",    ulSyncBitCount)
+    && SetParameter(m_sSysClass, "highStateEdge",   ulHighStateEdge)
+    && SetParameter(m_sSysClass, "bitZeroDuration", ulBitZeroDuration)
+    && SetParameter(m_sSysClass, "bitOneDuration",  ulBitOneDuration)
+    && SetParameter(m_sSysClass, "bitSyncDuration", ulBitSyncDuration)
+  ;
+}
+
+bool CGPIOWire::ConfigureFraming(bool bKernelFraming, bool bCRC)
+{
+  unsigned int uiSTX = (unsigned char)m_cSTX;
+  unsigned int uiETX = (unsigned char)m_cETX;
+
+  return
+       SetParameter(m_sSysClass, "frameSTX",      uiSTX)
+    && SetParameter(m_sSysClass, "frameETX",      uiETX)
+    && SetParameter(m_sSysClass, "frameCRC",      bCRC)
+    && SetParameter(m_sSysClass, "frameEncoding", bKernelFraming)
+  ;
+}
+
+bool CGPIOWire::ConfigureRepetition(
+  unsigned long ulRepeatCount,
+  unsigned long ulRepeatGap
+)
+{
+  m_LineCode.ulRepeatCount = ulRepeatCount;
+  m_LineCode.ulRepeatGap   = ulRepeatGap;
+
+  return
+       SetParameter(m_sSysClass, "frameRepeatGap",   ulRepeatGap)
+    && SetParameter(m_sSysClass, "frameRepeatCount", ulRepeatCount)
+  ;
+}
+
+bool CGPIOWire::ConfigureFrameGap(unsigned long ulFrameGap)
+{
+  m_LineCode.ulFrameGap = ulFrameGap;
+
+  return SetParameter(m_sSysClass, "frameGap", ulFrameGap);
+}
+
+bool CGPIOWire::ConfigureFrameSync(
+  bool          bFrameSync,
+  unsigned long ulResyncInterval
+)
+{
+  m_LineCode.bFrameSync       = bFrameSync;
+  m_LineCode.ulResyncInterval = ulResyncInterval;
 
   return
-       SetParameter(sSysClass, "pinNumber",       ulPinNumber)
-    && SetParameter(sSysClass, "canSleep",        bCanSleep)
-    && SetParameter(sSysClass, "swapOutput",      bSwapOutput)
-    && SetParameter(sSysClass, "bitSyncCount",    ulSyncBitCount)
-    && SetParameter(sSysClass, "highStateEdge",   ulHighStateEdge)
-    && SetParameter(sSysClass, "bitZeroDuration", ulBitZeroDuration)
-    && SetParameter(sSysClass, "bitOneDuration",  ulBitOneDuration)
-    && SetParameter(sSysClass, "bitSyncDuration", ulBitSyncDuration)
+       SetParameter(m_sSysClass, "resyncInterval", ulResyncInterval)
+    && SetParameter(m_sSysClass, "frameSync",      bFrameSync)
   ;
 }
 
+bool CGPIOWire::ConfigureMultiLevel(
+  bool          bMultiLevel,
+  unsigned long ulSymbolTwoDuration,
+  unsigned long ulSymbolThreeDuration
+)
+{
+  m_LineCode.bMultiLevel           = bMultiLevel;
+  m_LineCode.ulSymbolTwoDuration   = ulSymbolTwoDuration;
+  m_LineCode.ulSymbolThreeDuration = ulSymbolThreeDuration;
+
+  return
+       SetParameter(m_sSysClass, "symbolTwoDuration",   ulSymbolTwoDuration)
+    && SetParameter(m_sSysClass, "symbolThreeDuration", ulSymbolThreeDuration)
+    && SetParameter(m_sSysClass, "multiLevel",          bMultiLevel)
+  ;
+}
+
+bool CGPIOWire::LoadConfiguration()
+{
+  SGPIOWireLineCode& LineCode = m_LineCode;
+
+  return
+       GetParameter(m_sSysClass, "bitSyncCount",        LineCode.ulSyncBitCount)
+    && GetParameter(m_sSysClass, "highStateEdge",       LineCode.ulHighStateEdge)
+    && GetParameter(m_sSysClass, "bitZeroDuration",     LineCode.ulBitZeroDuration)
+    && GetParameter(m_sSysClass, "bitOneDuration",      LineCode.ulBitOneDuration)
+    && GetParameter(m_sSysClass, "bitSyncDuration",     LineCode.ulBitSyncDuration)
+    && GetParameter(m_sSysClass, "frameSync",           LineCode.bFrameSync)
+    && GetParameter(m_sSysClass, "resyncInterval",      LineCode.ulResyncInterval)
+    && GetParameter(m_sSysClass, "multiLevel",          LineCode.bMultiLevel)
+    && GetParameter(m_sSysClass, "symbolTwoDuration",   LineCode.ulSymbolTwoDuration)
+    && GetParameter(m_sSysClass, "symbolThreeDuration", LineCode.ulSymbolThreeDuration)
+    && GetParameter(m_sSysClass, "frameRepeatCount",    LineCode.ulRepeatCount)
+    && GetParameter(m_sSysClass, "frameRepeatGap",      LineCode.ulRepeatGap)
+    && GetParameter(m_sSysClass, "frameGap",            LineCode.ulFrameGap)
+  ;
+}
+
+const SGPIOWireLineCode& CGPIOWire::GetLineCode() const
+{
+  return m_LineCode;
+}
+
+void CGPIOWire::SetLineCode(const SGPIOWireLineCode& LineCode)
+{
+  m_LineCode = LineCode;
+}
+
 unsigned char* CGPIOWire::CreateMessage(
   const char* lpData,
   size_t&     nSize,
   bool        bCRC
 )
 {
-  size_t nBufferSize = (nSize + 2); // STX + ETX
+  size_t         nBufferSize = GetMaxMessageSize(nSize, bCRC);
+  unsigned char* lpBuffer    =
+    (unsigned char *)calloc(sizeof(char), nBufferSize);
+
+  nSize = CreateMessage(
+    string_view(lpData, nSize),
+    lpBuffer,
+    nBufferSize,
+    bCRC
+  );
+
+  if (!nSize)
+  {
+    free(lpBuffer);
+
+    return NULL;
+  }
+
+  return lpBuffer;
+}
+
+size_t CGPIOWire::GetMaxMessageSize(size_t nSize, bool bCRC)
+{
+  if (m_bCompression)
+  {
+    nSize = CCompression::GetMaxCompressedSize(nSize);
+  }
 
   if (bCRC)
   {
-    nBufferSize += 2;
+    nSize += 2;
   }
 
-  unsigned char* lpBuffer =
-    (unsigned char *)calloc(sizeof(char), nBufferSize);
+  return (
+      1                         // STX
+    + (m_bAddressing   ? 1 : 0) // ADDR
+    + (m_bLengthPrefix ? 2 : 0) // LEN + ~LEN
+    + (m_bFEC ? CFEC::GetEncodedSize(nSize) : nSize)
+    + (m_bLengthPrefix ? 0 : 1) // ETX
+  );
+}
+
+size_t CGPIOWire::CreateMessage(
+  string_view    sData,
+  unsigned char* lpBuffer,
+  size_t         nBufferSize,
+  bool           bCRC
+)
+{
+  assert(lpBuffer);
+
+  const unsigned char* lpData = (const unsigned char *)sData.data();
+  size_t               nSize  = sData.size();
 
-  lpBuffer[0]               = m_cSTX;
-  lpBuffer[nBufferSize - 1] = m_cETX;
+  if (m_bCompression)
+  {
+    // The payload is replaced by its compressed form (CRC included).
+
+    unsigned char* lpCompressed = Reserve(
+      m_lpCompressionBuffer,
+      CCompression::GetMaxCompressedSize(nSize)
+    );
+
+    nSize  = CCompression::Compress(lpData, nSize, lpCompressed);
+    lpData = lpCompressed;
+  }
+
+  size_t nBodySize = nSize;
 
   if (bCRC)
   {
+    nBodySize += 2;
+  }
+
+  size_t nEncodedSize = (m_bFEC ? CFEC::GetEncodedSize(nBodySize) : nBodySize);
+  size_t nHeaderSize  = (
+      1                         // STX
+    + (m_bAddressing   ? 1 : 0) // ADDR
+    + (m_bLengthPrefix ? 2 : 0) // LEN + ~LEN
+  );
+  size_t nTrailerSize = (m_bLengthPrefix ? 0 : 1); // [ETX]
+  size_t nMessageSize = (nHeaderSize + nEncodedSize + nTrailerSize);
+
+  if (
+       (nMessageSize > nBufferSize)
+    || (m_bLengthPrefix && (nEncodedSize > DEF_GPIO_ENCODER_MAX_LENGTH))
+  )
+  {
+    return 0;
+  }
+
+  size_t nIndex = 0;
+
+  lpBuffer[nIndex++] = m_cSTX;
+
+  if (m_bAddressing)
+  {
+    lpBuffer[nIndex++] = m_cAddress;
+  }
+
+  if (m_bLengthPrefix)
+  {
+    lpBuffer[nIndex++] = (unsigned char)nEncodedSize;
+    lpBuffer[nIndex++] = (unsigned char)~nEncodedSize;
+  }
+  else
+  {
+    lpBuffer[nMessageSize - 1] = m_cETX;
+  }
+
+  // With FEC the body is built aside, then encoded into the frame.
+
+  unsigned char* lpBody = (
+      m_bFEC
+    ? Reserve(m_lpBodyBuffer, nBodySize)
+    : (lpBuffer + nHeaderSize)
+  );
+
+  memcpy(lpBody, lpData, nSize);
+
+  if (bCRC)
+  {
+    // The destination address is covered by CRC as well
+
     uint16_t nCRC = CUtils::CRC16(
-      (unsigned char *)lpData,
-      nSize
+      lpData,
+      nSize,
+      (
+          m_bAddressing
+        ? CUtils::CRC16((unsigned char *)&m_cAddress, 1)
+        : 0xFFFF
+      )
     );
 
-    lpBuffer[nBufferSize - 2] = (nCRC & 0xFF);
-    lpBuffer[nBufferSize - 3] = ((nCRC >> 8) & 0xFF);
+    lpBody[nSize]     = ((nCRC >> 8) & 0xFF);
+    lpBody[nSize + 1] = (nCRC & 0xFF);
   }
 
-  memcpy(
-    (lpBuffer + sizeof(char)),
-    lpData,
-    nSize
-  );
+  if (m_bFEC)
+  {
+    CFEC::Encode(lpBody, nBodySize, (lpBuffer + nHeaderSize));
+  }
+
+  return nMessageSize;
+}
 
-  nSize = nBufferSize;
+size_t CGPIOWire::CreateArenaMessage(string_view sData, bool bCRC)
+{
+  size_t nBufferSize = GetMaxMessageSize(sData.size(), bCRC);
 
-  return lpBuffer;
+  return CreateMessage(
+    sData,
+    Reserve(m_lpArena, nBufferSize),
+    nBufferSize,
+    bCRC
+  );
+}
+
+const unsigned char* CGPIOWire::GetArenaMessage() const
+{
+  return m_lpArena.data();
 }
 
 unsigned char* CGPIOWire::CreateMessage(
@@ -118,11 +365,37 @@ unsigned char* CGPIOWire::CreateMessage(
   return CreateMessage(sData.c_str(), nSize, bCRC);
 }
 
+void CGPIOWire::SetCompression(bool bCompression)
+{
+  m_bCompression = bCompression;
+}
+
+void CGPIOWire::SetDestination(bool bAddressing, char cAddress)
+{
+  m_bAddressing = bAddressing;
+  m_cAddress    = cAddress;
+}
+
+void CGPIOWire::SetFEC(bool bFEC)
+{
+  m_bFEC = bFEC;
+}
+
+void CGPIOWire::SetLengthPrefix(bool bLengthPrefix)
+{
+  m_bLengthPrefix = bLengthPrefix;
+}
+
 bool CGPIOWire::Exists()
 {
   return CUtils::FileExists(m_sDevice);
 }
 
+CGPIOWireSession CGPIOWire::OpenSession()
+{
+  return CGPIOWireSession(m_sDevice);
+}
+
 void CGPIOWire::FreeMessage(unsigned char* lpMessage)
 {
   assert(lpMessage);
@@ -156,6 +429,393 @@ bool CGPIOWire::SendMessage(const unsigned char* lpMessage, size_t nSize)
   return true;
 }
 
+size_t CGPIOWire::SendMessages(
+  const unsigned char* const* lpMessages,
+  const size_t*               lpSizes,
+  size_t                      nCount
+)
+{
+  assert(lpMessages);
+  assert(lpSizes);
+
+  if (!nCount)
+  {
+    return 0;
+  }
+
+  vector<struct iovec> lpFrames(nCount);
+
+  for (size_t nIndex = 0; nIndex < nCount; nIndex++)
+  {
+    lpFrames[nIndex].iov_base = (void *)lpMessages[nIndex];
+    lpFrames[nIndex].iov_len  = lpSizes[nIndex];
+  }
+
+  int iHandle = open(m_sDevice.c_str(), O_WRONLY);
+
+  if (-1 == iHandle)
+  {
+    return 0;
+  }
+
+  ssize_t nBytesWritten = writev(iHandle, lpFrames.data(), nCount);
+
+  close(iHandle);
+
+  if (-1 == nBytesWritten)
+  {
+    return 0;
+  }
+
+  // The module only accounts frames which have been completely transmitted.
+
+  size_t nSent = 0;
+
+  while (
+       (nSent < nCount)
+    && ((size_t)nBytesWritten >= lpSizes[nSent])
+  )
+  {
+    nBytesWritten -= lpSizes[nSent];
+    nSent++;
+  }
+
+  return nSent;
+}
+
+void CGPIOWire::ConfigureBatch(
+  size_t        nMaxPayload,
+  unsigned long ulMaxDelay,
+  bool          bCRC
+)
+{
+  assert(nMaxPayload > 2); // Count + length + one byte record
+
+  m_nBatchMaxPayload = nMaxPayload;
+  m_ulBatchMaxDelay  = ulMaxDelay;
+  m_bBatchCRC        = bCRC;
+}
+
+bool CGPIOWire::AddRecord(const unsigned char* lpRecord, size_t nSize)
+{
+  assert(lpRecord);
+  assert(m_nBatchMaxPayload > 0);
+
+  if (
+       !IsBinarySafe()
+    || (nSize > DEF_GPIO_BATCH_MAX_RECORD)
+    || ((2 + nSize) > m_nBatchMaxPayload)
+  )
+  {
+    return false;
+  }
+
+  size_t nPayloadSize = (1 + m_lpBatchLengths.size() + m_lpBatchData.size());
+
+  if (
+       !m_lpBatchLengths.empty()
+    && (
+            ((nPayloadSize + 1 + nSize) > m_nBatchMaxPayload)
+         || (m_lpBatchLengths.size() >= DEF_GPIO_BATCH_MAX_RECORDS)
+       )
+  )
+  {
+    if (!FlushBatch())
+    {
+      return false;
+    }
+  }
+
+  if (m_lpBatchLengths.empty())
+  {
+    m_ulBatchStart = CUtils::GetMonotonicTime();
+  }
+
+  m_lpBatchLengths.push_back((unsigned char)nSize);
+  m_lpBatchData.insert(m_lpBatchData.end(), lpRecord, (lpRecord + nSize));
+
+  // Queued: a failed timed flush keeps it, reported by the next
+  // PollBatch() or FlushBatch()
+
+  PollBatch();
+
+  return true;
+}
+
+bool CGPIOWire::PollBatch()
+{
+  if (
+       !m_lpBatchLengths.empty()
+    && ((CUtils::GetMonotonicTime() - m_ulBatchStart) >= m_ulBatchMaxDelay)
+  )
+  {
+    return FlushBatch();
+  }
+
+  return true;
+}
+
+bool CGPIOWire::FlushBatch()
+{
+  if (m_lpBatchLengths.empty())
+  {
+    return true;
+  }
+
+  size_t         nSize     = 0;
+  unsigned char* lpMessage = BuildBatchMessage(nSize);
+
+  if (!lpMessage)
+  {
+    return false;
+  }
+
+  bool bSent = SendMessage(lpMessage, nSize);
+
+  FreeMessage(lpMessage);
+
+  // Records are kept for the next flush when the send failed
+
+  if (bSent)
+  {
+    ClearBatch();
+  }
+
+  return bSent;
+}
+
+size_t CGPIOWire::GetBatchRecordCount()
+{
+  return m_lpBatchLengths.size();
+}
+
+unsigned char* CGPIOWire::CreateBatchMessage(size_t& nSize)
+{
+  unsigned char* lpMessage = BuildBatchMessage(nSize);
+
+  if (lpMessage)
+  {
+    ClearBatch();
+  }
+
+  return lpMessage;
+}
+
+bool CGPIOWire::IsBinarySafe() const
+{
+  // Neither a length prefixed nor a FEC body can end at an ETX byte
+
+  return (m_bLengthPrefix || m_bFEC);
+}
+
+unsigned char* CGPIOWire::BuildBatchMessage(size_t& nSize)
+{
+  if (m_lpBatchLengths.empty())
+  {
+    nSize = 0;
+
+    return NULL;
+  }
+
+  vector<unsigned char> lpPayload;
+
+  lpPayload.reserve(1 + m_lpBatchLengths.size() + m_lpBatchData.size());
+  lpPayload.push_back((unsigned char)m_lpBatchLengths.size());
+
+  lpPayload.insert(
+    lpPayload.end(),
+    m_lpBatchLengths.begin(),
+    m_lpBatchLengths.end()
+  );
+
+  lpPayload.insert(
+    lpPayload.end(),
+    m_lpBatchData.begin(),
+    m_lpBatchData.end()
+  );
+
+  nSize = lpPayload.size();
+
+  return CreateMessage((const char *)lpPayload.data(), nSize, m_bBatchCRC);
+}
+
+void CGPIOWire::ClearBatch()
+{
+  m_lpBatchLengths.clear();
+  m_lpBatchData.clear();
+}
+
+void CGPIOWire::SetFragmentMTU(size_t nMTU)
+{
+  assert(nMTU > DEF_GPIO_FRAGMENT_HEADER);
+
+  m_nFragmentMTU = nMTU;
+}
+
+size_t CGPIOWire::GetFragmentCount(size_t nSize)
+{
+  assert(m_nFragmentMTU > DEF_GPIO_FRAGMENT_HEADER);
+
+  size_t nChunkSize = (m_nFragmentMTU - DEF_GPIO_FRAGMENT_HEADER);
+
+  return (nSize ? ((nSize + nChunkSize - 1) / nChunkSize) : 1);
+}
+
+size_t CGPIOWire::SendFragments(
+  const char*          lpData,
+  size_t               nSize,
+  unsigned char        uiMessageId,
+  bool                 bCRC,
+  const unsigned char* lpReceived
+)
+{
+  assert(lpData || !nSize);
+
+  size_t nCount     = GetFragmentCount(nSize);
+  size_t nChunkSize = (m_nFragmentMTU - DEF_GPIO_FRAGMENT_HEADER);
+
+  if (!IsBinarySafe() || (nCount > DEF_GPIO_FRAGMENT_MAX_COUNT))
+  {
+    return 0;
+  }
+
+  vector<unsigned char>  lpFragment(m_nFragmentMTU);
+  vector<unsigned char*> lpFrames;
+  vector<size_t>         lpFrameSizes;
+
+  for (size_t nIndex = 0; nIndex < nCount; nIndex++)
+  {
+    if (lpReceived && (lpReceived[nIndex / 8] & (1 << (nIndex % 8))))
+    {
+      continue;
+    }
+
+    size_t nOffset    = (nIndex * nChunkSize);
+    size_t nChunk     = min(nChunkSize, (nSize - nOffset));
+    size_t nFrameSize = (DEF_GPIO_FRAGMENT_HEADER + nChunk);
+
+    lpFragment[0] = uiMessageId;
+    lpFragment[1] = (unsigned char)nIndex;
+    lpFragment[2] = (unsigned char)nCount;
+
+    memcpy(&lpFragment[DEF_GPIO_FRAGMENT_HEADER], (lpData + nOffset), nChunk);
+
+    unsigned char* lpFrame = CreateMessage(
+      (const char *)lpFragment.data(),
+      nFrameSize,
+      bCRC
+    );
+
+    if (!lpFrame)
+    {
+      break;
+    }
+
+    lpFrames.push_back(lpFrame);
+    lpFrameSizes.push_back(nFrameSize);
+  }
+
+  size_t nSent = 0;
+
+  if (!lpFrames.empty())
+  {
+    nSent = SendMessages(lpFrames.data(), lpFrameSizes.data(), lpFrames.size());
+  }
+
+  for (size_t nIndex = 0; nIndex < lpFrames.size(); nIndex++)
+  {
+    FreeMessage(lpFrames[nIndex]);
+  }
+
+  return nSent;
+}
+
+unsigned long CGPIOWire::GetAirTime(
+  const unsigned char* lpMessage,
+  size_t               nSize
+)
+{
+  // Idle repeat gaps still delay the end of the transmission
+
+  return (
+      GetOnAirTime(lpMessage, nSize)
+    + (m_LineCode.ulRepeatGap * m_LineCode.ulRepeatCount)
+  );
+}
+
+unsigned long CGPIOWire::GetOnAirTime(
+  const unsigned char* lpMessage,
+  size_t               nSize
+)
+{
+  assert(lpMessage);
+
+  const SGPIOWireLineCode& LineCode = m_LineCode;
+
+  unsigned long ulAirTime = LineCode.ulHighStateEdge; // Closing high edge
+
+  for (size_t nIndex = 0; nIndex < nSize; nIndex++)
+  {
+    // Sync bits, as sent by the module
+
+    if (
+         !LineCode.bFrameSync
+      || (0 == nIndex)
+      || ((LineCode.ulResyncInterval > 0) && (0 == (nIndex % LineCode.ulResyncInterval)))
+    )
+    {
+      ulAirTime += (LineCode.ulSyncBitCount * LineCode.ulBitSyncDuration);
+    }
+
+    unsigned char nByte = lpMessage[nIndex];
+
+    if (LineCode.bMultiLevel)
+    {
+      for (int iSymbol = 0; iSymbol < 4; iSymbol++, nByte <<= 2)
+      {
+        switch (nByte & 0xC0)
+        {
+          case 0x00: ulAirTime += LineCode.ulBitZeroDuration;     break;
+          case 0x40: ulAirTime += LineCode.ulBitOneDuration;      break;
+          case 0x80: ulAirTime += LineCode.ulSymbolTwoDuration;   break;
+          default:   ulAirTime += LineCode.ulSymbolThreeDuration; break;
+        }
+      }
+    }
+    else
+    {
+      for (int iBit = 0; iBit < 8; iBit++, nByte <<= 1)
+      {
+        ulAirTime += (
+            (nByte & 0x80)
+          ? LineCode.ulBitOneDuration
+          : LineCode.ulBitZeroDuration
+        );
+      }
+    }
+  }
+
+  // Replayed by the module
+
+  return (ulAirTime * (LineCode.ulRepeatCount + 1));
+}
+
+unsigned char* CGPIOWire::Reserve(
+  vector<unsigned char>& lpBuffer,
+  size_t                 nSize
+)
+{
+  // Grows only, so that reuse does not allocate (never empty, so that data()
+  // is valid for empty payloads too)
+
+  if (lpBuffer.size() < max(nSize, (size_t)1))
+  {
+    lpBuffer.resize(max(nSize, (size_t)1));
+  }
+
+  return lpBuffer.data();
+}
+
 bool CGPIOWire::SetParameter(
   const string& sSysClass,
   const string& sName,
@@ -226,4 +886,60 @@ bool CGPIOWire::SetParameter(
     sName,
     CUtils::UnsignedLongToString(ulValue)
   );
-}
\ No newline at end of file
+}
+
+bool CGPIOWire::GetParameter(
+  const string&  sSysClass,
+  const string&  sName,
+  unsigned long& ulValue
+)
+{
+  string sPath = CUtils::FormatString(
+    "%s/settings/%s",
+    sSysClass.c_str(),
+    sName.c_str()
+  );
+
+  int iHandle = open(sPath.c_str(), O_RDONLY);
+
+  if (-1 == iHandle)
+  {
+    return false;
+  }
+
+  char    szValue[32];
+  ssize_t nBytesRead = read(iHandle, szValue, (sizeof(szValue) - 1));
+
+  close(iHandle);
+
+  if (nBytesRead <= 0)
+  {
+    return false;
+  }
+
+  szValue[nBytesRead] = '\0';
+
+  char* lpszEnd = NULL;
+
+  ulValue = strtoul(szValue, &lpszEnd, 10);
+
+  return (lpszEnd != szValue);
+}
+
+bool CGPIOWire::GetParameter(
+  const string& sSysClass,
+  const string& sName,
+  bool&         bValue
+)
+{
+  unsigned long ulValue;
+
+  if (!GetParameter(sSysClass, sName, ulValue))
+  {
+    return false;
+  }
+
+  bValue = (0 != ulValue);
+
+  return true;
+}
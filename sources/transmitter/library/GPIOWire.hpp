@@ -21,13 +21,47 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef _GPIO_WIRE_HPP_
 #define _GPIO_WIRE_HPP_
 
+#include <Compression.hpp>
+#include <FEC.hpp>
+#include <GPIOWireSession.hpp>
 #include <Utils.hpp>
 
+#include <string_view>
+#include <vector>
+
 // http://www.romanblack.com/RF/cheapRFmodules.htm
 
 #define DEF_GPIO_ENCODER_STX '\x02'
 #define DEF_GPIO_ENCODER_ETX '\x03'
 
+#define DEF_GPIO_ENCODER_MAX_LENGTH 255
+#define DEF_GPIO_ENCODER_BROADCAST  '\xFF'
+
+#define DEF_GPIO_BATCH_MAX_RECORDS  255
+#define DEF_GPIO_BATCH_MAX_RECORD   255
+
+#define DEF_GPIO_FRAGMENT_HEADER    3   // Message id, index, count
+#define DEF_GPIO_FRAGMENT_MAX_COUNT 255
+
+// Line code timings (uS), kernel module defaults.
+
+struct SGPIOWireLineCode
+{
+  unsigned long ulSyncBitCount        = 5;
+  unsigned long ulHighStateEdge       = 500;
+  unsigned long ulBitZeroDuration     = 1000;
+  unsigned long ulBitOneDuration      = 2000;
+  unsigned long ulBitSyncDuration     = 5000;
+  bool          bFrameSync            = false;
+  unsigned long ulResyncInterval      = 0;
+  bool          bMultiLevel           = false;
+  unsigned long ulSymbolTwoDuration   = 2500;
+  unsigned long ulSymbolThreeDuration = 3000;
+  unsigned long ulRepeatCount         = 0;
+  unsigned long ulRepeatGap           = 20000;
+  unsigned long ulFrameGap            = 20000;
+};
+
 class CGPIOWire
 {
 public:
@@ -46,6 +80,73 @@ public:
     char          cETX = DEF_GPIO_ENCODER_ETX
   );
 
+  // With kernel framing enabled the module adds STX, CRC and ETX by itself,
+  // so the raw payload has to be passed to SendMessage() as is.
+
+  bool ConfigureFraming(bool bKernelFraming, bool bCRC);
+
+  // Each written frame is replayed by the module ulRepeatCount more times,
+  // ulRepeatGap uS apart, without any further system call.
+
+  bool ConfigureRepetition(
+    unsigned long ulRepeatCount,
+    unsigned long ulRepeatGap
+  );
+
+  // Minimum low state gap (uS) between frames sent by SendMessages().
+
+  bool ConfigureFrameGap(unsigned long ulFrameGap);
+
+  // Sync bits are sent as a frame preamble only (plus every
+  // ulResyncInterval bytes, when not zero) instead of before each byte:
+  // the receiver has to be initialized in frame sync mode too.
+
+  bool ConfigureFrameSync(bool bFrameSync, unsigned long ulResyncInterval);
+
+  // Two bits per pulse: bit zero and bit one durations encode symbols 00 and
+  // 01, ulSymbolTwoDuration and ulSymbolThreeDuration encode 10 and 11.
+
+  bool ConfigureMultiLevel(
+    bool          bMultiLevel,
+    unsigned long ulSymbolTwoDuration,
+    unsigned long ulSymbolThreeDuration
+  );
+
+  // Reads the line code (timings, frame sync, multi level, repetitions)
+  // back from the module, so that GetAirTime() is right even when another
+  // process configured it.
+
+  bool LoadConfiguration();
+
+  // The line code known by this object: Configure*() and
+  // LoadConfiguration() update it, SetLineCode() only sets it locally (no
+  // module, e.g. for CGPIOWireLine).
+
+  const SGPIOWireLineCode& GetLineCode() const;
+  void                     SetLineCode(const SGPIOWireLineCode& LineCode);
+
+  // Forward error correction (interleaved Hamming 7,4) of payload and CRC,
+  // applied by CreateMessage(): the receiver has to decode it as well.
+
+  void SetFEC(bool bFEC);
+
+  // Static dictionary compression of the payload, applied by
+  // CreateMessage() before CRC and FEC: the receiver has to decompress it.
+
+  void SetCompression(bool bCompression);
+
+  // Binary safe frames: STX, length, length complement and the (encoded)
+  // body, without ETX. CreateMessage() returns NULL when the body exceeds
+  // DEF_GPIO_ENCODER_MAX_LENGTH bytes.
+
+  void SetLengthPrefix(bool bLengthPrefix);
+
+  // Adds a destination address byte right after STX (outside FEC, covered
+  // by CRC): receivers drop frames addressed elsewhere as soon as it
+  // arrives. DEF_GPIO_ENCODER_BROADCAST reaches every node.
+
+  void SetDestination(bool bAddressing, char cAddress);
+
   unsigned char* CreateMessage(
     const char* lpData, 
     size_t&     nSize, 
@@ -59,19 +160,143 @@ public:
   );
   
   static void FreeMessage(unsigned char* lpData);
+
+  // Zero allocation API: frames are written into a caller buffer, or into a
+  // per object arena reused by each call (valid until the next one), and
+  // their size is returned (0 on failure). Compression and FEC work buffers
+  // are kept by the object as well, so sends do no heap operations once
+  // they have grown to the largest frame.
+
+  size_t GetMaxMessageSize(size_t nSize, bool bCRC);
+
+  size_t CreateMessage(
+    string_view    sData,
+    unsigned char* lpBuffer,
+    size_t         nBufferSize,
+    bool           bCRC
+  );
+
+  size_t               CreateArenaMessage(string_view sData, bool bCRC);
+  const unsigned char* GetArenaMessage() const;
+
+  // Record batching: small records are packed into a single frame whose
+  // payload is the record count, one length byte per record and the records
+  // themselves. The frame is sent as soon as nMaxPayload bytes would be
+  // exceeded, or by PollBatch() once the oldest record is ulMaxDelay mS old.
+  //
+  // The payload is binary (a count or a length may equal ETX), so batching
+  // needs length prefixed or FEC frames: AddRecord() fails otherwise. When a
+  // send fails the records are kept for the next flush.
+  //
+  // AddRecord() returns false only when the record was not queued (too
+  // large, or the full batch ahead of it could not be sent): retry it then.
+  // Once queued it returns true, even when its timed flush failed.
+
+  void ConfigureBatch(size_t nMaxPayload, unsigned long ulMaxDelay, bool bCRC);
+
+  bool AddRecord(const unsigned char* lpRecord, size_t nSize);
+  bool PollBatch();
+  bool FlushBatch();
+
+  size_t GetBatchRecordCount();
+
+  // Builds the frame of the pending records (NULL if none) and empties the
+  // batch, without sending it (the batch is kept on failure).
+
+  unsigned char* CreateBatchMessage(size_t& nSize);
+
+  // Fragmentation: payloads larger than the receiver buffer are split into
+  // frames carrying a header (message id, fragment index, fragment count)
+  // plus up to nMTU - DEF_GPIO_FRAGMENT_HEADER bytes. The receiver has to
+  // use the same MTU (payload bytes per frame, CRC excluded). The header is
+  // binary (an index may equal ETX), so fragments need length prefixed or
+  // FEC frames.
+
+  void   SetFragmentMTU(size_t nMTU);
+  size_t GetFragmentCount(size_t nSize);
+
+  // Sends the fragments by a single vectored write, skipping the ones set in
+  // lpReceived (receiver bitmap, bit N % 8 of byte N / 8) when given, and
+  // returns how many of them have been sent (none without binary safe
+  // frames).
+
+  size_t SendFragments(
+    const char*          lpData,
+    size_t               nSize,
+    unsigned char        uiMessageId,
+    bool                 bCRC,
+    const unsigned char* lpReceived = NULL
+  );
+
+  // Time (uS) needed to transmit a message with the configured line code,
+  // repetitions and the gaps between them included.
+
+  unsigned long GetAirTime(const unsigned char* lpMessage, size_t nSize);
+
+  // Same without the repeat gaps (the line idles low): the time actually
+  // spent on air, as duty cycle limits count it.
+
+  unsigned long GetOnAirTime(const unsigned char* lpMessage, size_t nSize);
   
   bool        Exists();
+
+  // Opens the device once for many sends (see CGPIOWireSession), instead of
+  // once per SendMessage() call.
+
+  CGPIOWireSession OpenSession();
   
   bool        SendMessage(
     const unsigned char* lpMessage, 
     size_t nSize
   );
 
+  // Sends a burst of frames by a single vectored write, returning how many
+  // of them (in order) have been completely transmitted.
+
+  size_t      SendMessages(
+    const unsigned char* const* lpMessages,
+    const size_t*               lpSizes,
+    size_t                      nCount
+  );
+
 private:
   string         m_sDevice;
+  string         m_sSysClass;
   unsigned short m_uiDeviceNumber;
   char           m_cETX;
   char           m_cSTX;
+  bool           m_bFEC;
+  bool           m_bCompression;
+  bool           m_bLengthPrefix;
+  bool           m_bAddressing;
+  char           m_cAddress;
+
+  // Line code (for air time estimation)
+
+  SGPIOWireLineCode m_LineCode;
+
+  // Record batching
+
+  vector<unsigned char> m_lpBatchLengths;
+  vector<unsigned char> m_lpBatchData;
+  size_t                m_nBatchMaxPayload;
+  unsigned long         m_ulBatchMaxDelay;
+  bool                  m_bBatchCRC;
+  uint64_t              m_ulBatchStart;
+
+  size_t                m_nFragmentMTU;
+
+  // Zero allocation work buffers
+
+  vector<unsigned char> m_lpArena;
+  vector<unsigned char> m_lpCompressionBuffer;
+  vector<unsigned char> m_lpBodyBuffer;
+
+  static unsigned char* Reserve(vector<unsigned char>& lpBuffer, size_t nSize);
+
+  bool           IsBinarySafe() const;
+  unsigned char* BuildBatchMessage(size_t& nSize);
+  void           ClearBatch();
   
   bool SetParameter(
     const string& sSysClass, 
@@ -96,6 +321,18 @@ private:
     const string& sName,
     unsigned long ulValue
   );
+
+  bool GetParameter(
+    const string&  sSysClass,
+    const string&  sName,
+    unsigned long& ulValue
+  );
+
+  bool GetParameter(
+    const string& sSysClass,
+    const string& sName,
+    bool&         bValue
+  );
 };
 
 #endif /* _GPIO_WIRE_HPP_ */
\ No newline at end of file
@@ -0,0 +1,601 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "GPIOWireClient.hpp"
+#include "Utils.hpp"
+
+#define CLIENT_MAX_PACKET 65536 // Statistics replies included
+#define CLIENT_MAX_FILES  2 // Attach reply: doorbell and completion
+
+CGPIOWireClient::CGPIOWireClient(
+  unsigned short uiDeviceNumber,
+  const string&  sSocket
+)
+  : m_uiDeviceNumber(uiDeviceNumber)
+  , m_sSocket(sSocket)
+  , m_uiPriority(0)
+  , m_iSocket(-1)
+  , m_uiSequence(0)
+  , m_LastResult({ 0, NULL, 0 })
+  , m_lpRing(NULL)
+  , m_nRingMapSize(0)
+  , m_iDoorbell(-1)
+  , m_iCompletion(-1)
+  , m_ulPosted(0)
+{
+}
+
+CGPIOWireClient::~CGPIOWireClient()
+{
+  Disconnect();
+}
+
+bool CGPIOWireClient::Exists()
+{
+  return Connect();
+}
+
+void CGPIOWireClient::SetPriority(unsigned int uiPriority)
+{
+  assert(uiPriority < DEF_GPIOWIRED_PRIORITIES);
+
+  m_uiPriority = uiPriority;
+}
+
+bool CGPIOWireClient::SendMessage(
+  const unsigned char* lpMessage,
+  size_t               nSize
+)
+{
+  if (nSize > DEF_GPIOWIRED_MAX_FRAME)
+  {
+    return SetResult(EMSGSIZE, "send");
+  }
+
+  SGPIOWireRequest Request = {
+    GPIOWIRE_REQUEST_SEND,
+    (uint8_t)m_uiPriority,
+    m_uiDeviceNumber,
+    0
+  };
+
+  return (
+       Connect()
+    && this->Request(Request, lpMessage, nSize, NULL, 0, NULL)
+  );
+}
+
+SGPIOWireResult CGPIOWireClient::GetLastResult() const
+{
+  return m_LastResult;
+}
+
+bool CGPIOWireClient::Attach(size_t nRingSize)
+{
+  if (
+       (nRingSize < 4096)
+    || (nRingSize > 0x80000000)
+    || (nRingSize & (nRingSize - 1))
+  )
+  {
+    return SetResult(EINVAL, "attach");
+  }
+
+  if (m_lpRing)
+  {
+    return SetResult(EALREADY, "attach");
+  }
+
+  if (!Connect())
+  {
+    return false;
+  }
+
+  // Sealed, so that the daemon can trust its size
+
+  size_t nMapSize = (sizeof(SGPIOWireRing) + nRingSize);
+  int    iMemory  = memfd_create(
+    "gpiowire-ring",
+    (MFD_CLOEXEC | MFD_ALLOW_SEALING)
+  );
+
+  if (-1 == iMemory)
+  {
+    return SetResult(errno, "memfd_create");
+  }
+
+  void* lpMap = MAP_FAILED;
+
+  if (
+       (0 == ftruncate(iMemory, nMapSize))
+    && (0 == fcntl(iMemory, F_ADD_SEALS, (F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL)))
+  )
+  {
+    lpMap = mmap(NULL, nMapSize, (PROT_READ | PROT_WRITE), MAP_SHARED, iMemory, 0);
+  }
+
+  if (MAP_FAILED == lpMap)
+  {
+    int iError = errno;
+
+    close(iMemory);
+
+    return SetResult(iError, "mmap");
+  }
+
+  m_lpRing       = (SGPIOWireRing *)lpMap;
+  m_nRingMapSize = nMapSize;
+  m_ulPosted     = 0;
+
+  m_lpRing->uiMagic = DEF_GPIOWIRED_RING_MAGIC;
+  m_lpRing->uiSize  = (uint32_t)nRingSize;
+  m_lpRing->uiWaiting.store(1, memory_order_relaxed);
+
+  SGPIOWireRequest Request = {
+    GPIOWIRE_REQUEST_ATTACH,
+    (uint8_t)m_uiPriority,
+    m_uiDeviceNumber,
+    0
+  };
+
+  // The daemon creates the doorbell and completion eventfds
+
+  int  lpEvents[CLIENT_MAX_FILES];
+  bool bResult = this->Request(
+    Request,
+    NULL,
+    0,
+    &iMemory,
+    1,
+    NULL,
+    lpEvents,
+    CLIENT_MAX_FILES
+  );
+
+  close(iMemory);
+
+  if (bResult)
+  {
+    m_iDoorbell   = lpEvents[0];
+    m_iCompletion = lpEvents[1];
+  }
+
+  if (!bResult)
+  {
+    SGPIOWireResult Result = m_LastResult;
+
+    Disconnect();
+
+    m_LastResult = Result;
+  }
+
+  return bResult;
+}
+
+bool CGPIOWireClient::PostMessage(
+  const unsigned char* lpMessage,
+  size_t               nSize
+)
+{
+  if (!m_lpRing)
+  {
+    return SetResult(ENOTCONN, "post");
+  }
+
+  if (nSize > DEF_GPIOWIRED_MAX_FRAME)
+  {
+    return SetResult(EMSGSIZE, "post");
+  }
+
+  unsigned char* lpData     = GetRingData(m_lpRing);
+  uint64_t       ulSize     = m_lpRing->uiSize;
+  uint64_t       ulHead     = m_lpRing->ulHead.load(memory_order_relaxed);
+  uint64_t       ulTail     = m_lpRing->ulTail.load(memory_order_acquire);
+  uint64_t       ulOffset   = (ulHead & (ulSize - 1));
+  uint64_t       ulRecord   = GetRingRecordSize(nSize);
+  uint64_t       ulSkip     = (((ulSize - ulOffset) < ulRecord) ? (ulSize - ulOffset) : 0);
+
+  if (((ulHead - ulTail) + ulSkip + ulRecord) > ulSize)
+  {
+    return SetResult(EAGAIN, "post");
+  }
+
+  SGPIOWireRingRecord Record = { 0, 0, 0, GPIOWIRE_RING_SKIP };
+
+  if (ulSkip)
+  {
+    memcpy((lpData + ulOffset), &Record, sizeof(Record));
+
+    ulHead  += ulSkip;
+    ulOffset = 0;
+  }
+
+  Record.uiDevice   = m_uiDeviceNumber;
+  Record.uiPriority = (uint8_t)m_uiPriority;
+  Record.uiSize     = (uint32_t)nSize;
+
+  memcpy((lpData + ulOffset), &Record, sizeof(Record));
+  memcpy((lpData + ulOffset + sizeof(Record)), lpMessage, nSize);
+
+  m_lpRing->ulHead.store((ulHead + ulRecord), memory_order_seq_cst);
+  m_ulPosted++;
+
+  // Wake the daemon up only when it went idle
+
+  if (m_lpRing->uiWaiting.exchange(0, memory_order_seq_cst))
+  {
+    uint64_t ulValue = 1;
+
+    if (write(m_iDoorbell, &ulValue, sizeof(ulValue))) {}
+  }
+
+  return SetResult(0, NULL);
+}
+
+bool CGPIOWireClient::Flush(int iTimeout)
+{
+  if (!m_lpRing)
+  {
+    return SetResult(ENOTCONN, "flush");
+  }
+
+  uint64_t ulDeadline = (CUtils::GetMonotonicTime() + iTimeout);
+
+  while (m_lpRing->ulCompleted.load(memory_order_acquire) < m_ulPosted)
+  {
+    int iWait = -1;
+
+    if (iTimeout >= 0)
+    {
+      uint64_t ulNow = CUtils::GetMonotonicTime();
+
+      if (ulNow >= ulDeadline)
+      {
+        return SetResult(ETIMEDOUT, "flush");
+      }
+
+      iWait = (int)(ulDeadline - ulNow);
+    }
+
+    struct pollfd lpFiles[2] = {
+      { m_iCompletion, POLLIN, 0 },
+      { m_iSocket,     POLLIN, 0 }
+    };
+
+    if (-1 == poll(lpFiles, 2, iWait))
+    {
+      if (EINTR != errno)
+      {
+        return SetResult(errno, "poll");
+      }
+
+      continue;
+    }
+
+    // No packets are expected but replies: the daemon went away
+
+    if (lpFiles[1].revents)
+    {
+      Disconnect();
+
+      return SetResult(ECONNRESET, "flush");
+    }
+
+    uint64_t ulValue;
+
+    if (read(m_iCompletion, &ulValue, sizeof(ulValue))) {}
+  }
+
+  return SetResult(0, NULL);
+}
+
+uint64_t CGPIOWireClient::GetFailedCount() const
+{
+  return (m_lpRing ? m_lpRing->ulFailed.load(memory_order_acquire) : 0);
+}
+
+string CGPIOWireClient::GetStatistics()
+{
+  SGPIOWireRequest Request = {
+    GPIOWIRE_REQUEST_STATISTICS,
+    0,
+    m_uiDeviceNumber,
+    0
+  };
+
+  string sText;
+
+  if (
+       !Connect()
+    || !this->Request(Request, NULL, 0, NULL, 0, &sText)
+  )
+  {
+    return "";
+  }
+
+  return sText;
+}
+
+bool CGPIOWireClient::Connect()
+{
+  if (-1 != m_iSocket)
+  {
+    return true;
+  }
+
+  struct sockaddr_un Address = {};
+
+  if (m_sSocket.length() >= sizeof(Address.sun_path))
+  {
+    return SetResult(ENAMETOOLONG, "connect");
+  }
+
+  Address.sun_family = AF_UNIX;
+  strcpy(Address.sun_path, m_sSocket.c_str());
+
+  m_iSocket = socket(AF_UNIX, (SOCK_SEQPACKET | SOCK_CLOEXEC), 0);
+
+  if (-1 == m_iSocket)
+  {
+    return SetResult(errno, "socket");
+  }
+
+  if (-1 == connect(m_iSocket, (struct sockaddr *)&Address, sizeof(Address)))
+  {
+    int iError = errno;
+
+    Disconnect();
+
+    return SetResult(iError, "connect");
+  }
+
+  return SetResult(0, NULL);
+}
+
+void CGPIOWireClient::Disconnect()
+{
+  if (m_lpRing)
+  {
+    munmap(m_lpRing, m_nRingMapSize);
+
+    m_lpRing       = NULL;
+    m_nRingMapSize = 0;
+  }
+
+  if (-1 != m_iDoorbell)
+  {
+    close(m_iDoorbell);
+    m_iDoorbell = -1;
+  }
+
+  if (-1 != m_iCompletion)
+  {
+    close(m_iCompletion);
+    m_iCompletion = -1;
+  }
+
+  if (-1 != m_iSocket)
+  {
+    close(m_iSocket);
+    m_iSocket = -1;
+  }
+}
+
+bool CGPIOWireClient::Request(
+  const SGPIOWireRequest& Request,
+  const unsigned char*    lpData,
+  size_t                  nSize,
+  const int*              lpFiles,
+  size_t                  nFiles,
+  string*                 lpsText,
+  int*                    lpReplyFiles,
+  size_t                  nReplyFiles
+)
+{
+  assert(nFiles <= CLIENT_MAX_FILES);
+  assert(nReplyFiles <= CLIENT_MAX_FILES);
+
+  SGPIOWireRequest Header = Request;
+
+  Header.uiSequence = ++m_uiSequence;
+
+  struct iovec lpParts[2] = {
+    { &Header,         sizeof(Header) },
+    { (void *)lpData,  nSize          }
+  };
+
+  struct msghdr Message = {};
+
+  Message.msg_iov    = lpParts;
+  Message.msg_iovlen = (nSize ? 2 : 1);
+
+  // Descriptors passing
+
+  union
+  {
+    char           lpBuffer[CMSG_SPACE(CLIENT_MAX_FILES * sizeof(int))];
+    struct cmsghdr Align;
+  } Control;
+
+  if (nFiles)
+  {
+    Message.msg_control    = Control.lpBuffer;
+    Message.msg_controllen = CMSG_SPACE(nFiles * sizeof(int));
+
+    struct cmsghdr* lpControl = CMSG_FIRSTHDR(&Message);
+
+    lpControl->cmsg_level = SOL_SOCKET;
+    lpControl->cmsg_type  = SCM_RIGHTS;
+    lpControl->cmsg_len   = CMSG_LEN(nFiles * sizeof(int));
+
+    memcpy(CMSG_DATA(lpControl), lpFiles, (nFiles * sizeof(int)));
+  }
+
+  while (-1 == sendmsg(m_iSocket, &Message, MSG_NOSIGNAL))
+  {
+    if (EINTR != errno)
+    {
+      int iError = errno;
+
+      Disconnect();
+
+      return SetResult(iError, "sendmsg");
+    }
+  }
+
+  // Blocking until the matching reply
+
+  m_lpPacket.resize(CLIENT_MAX_PACKET);
+
+  for (;;)
+  {
+    struct iovec  Part     = { m_lpPacket.data(), m_lpPacket.size() };
+    struct msghdr Received = {};
+
+    Received.msg_iov        = &Part;
+    Received.msg_iovlen     = 1;
+    Received.msg_control    = Control.lpBuffer;
+    Received.msg_controllen = sizeof(Control.lpBuffer);
+
+    ssize_t nReceived = recvmsg(m_iSocket, &Received, MSG_CMSG_CLOEXEC);
+
+    // Descriptors, if any
+
+    int    lpReceived[CLIENT_MAX_FILES];
+    size_t nReceivedFiles = 0;
+
+    if (-1 != nReceived)
+    {
+      for (
+        struct cmsghdr* lpControl = CMSG_FIRSTHDR(&Received);
+        lpControl;
+        lpControl = CMSG_NXTHDR(&Received, lpControl)
+      )
+      {
+        if ((SOL_SOCKET != lpControl->cmsg_level) || (SCM_RIGHTS != lpControl->cmsg_type))
+        {
+          continue;
+        }
+
+        size_t nCount = ((lpControl->cmsg_len - CMSG_LEN(0)) / sizeof(int));
+        int*   lpData = (int *)CMSG_DATA(lpControl);
+
+        for (size_t nIndex = 0; nIndex < nCount; nIndex++)
+        {
+          if (nReceivedFiles < CLIENT_MAX_FILES)
+          {
+            lpReceived[nReceivedFiles++] = lpData[nIndex];
+          }
+          else
+          {
+            close(lpData[nIndex]);
+          }
+        }
+      }
+    }
+
+    SGPIOWireReply Reply = { 0, 0 };
+    int            iError = 0;
+
+    if (nReceived < (ssize_t)sizeof(SGPIOWireReply))
+    {
+      if ((-1 == nReceived) && (EINTR == errno))
+      {
+        continue;
+      }
+
+      iError = ((-1 == nReceived) ? errno : ECONNRESET);
+    }
+    else
+    {
+      memcpy(&Reply, m_lpPacket.data(), sizeof(Reply));
+
+      // Successful replies carry exactly the expected descriptors
+
+      if (
+           (Reply.uiSequence == Header.uiSequence)
+        && (0 == Reply.iError)
+        && (nReceivedFiles != nReplyFiles)
+      )
+      {
+        iError = EPROTO;
+      }
+    }
+
+    bool bKeep = (
+         !iError
+      && (Reply.uiSequence == Header.uiSequence)
+      && (0 == Reply.iError)
+    );
+
+    for (size_t nIndex = 0; nIndex < nReceivedFiles; nIndex++)
+    {
+      if (bKeep)
+      {
+        lpReplyFiles[nIndex] = lpReceived[nIndex];
+      }
+      else
+      {
+        close(lpReceived[nIndex]);
+      }
+    }
+
+    if (iError)
+    {
+      Disconnect();
+
+      return SetResult(iError, "recv");
+    }
+
+    if (Reply.uiSequence != Header.uiSequence)
+    {
+      continue;
+    }
+
+    if (lpsText)
+    {
+      lpsText->assign(
+        (const char *)(m_lpPacket.data() + sizeof(Reply)),
+        (nReceived - sizeof(Reply))
+      );
+    }
+
+    return SetResult(Reply.iError, "gpiowired");
+  }
+}
+
+bool CGPIOWireClient::SetResult(int iError, const char* lpszOperation)
+{
+  m_LastResult.iError        = iError;
+  m_LastResult.lpszOperation = (iError ? lpszOperation : NULL);
+  m_LastResult.nFrames       = (iError ? 0 : 1);
+
+  return (0 == iError);
+}
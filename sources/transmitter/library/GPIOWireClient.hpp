@@ -0,0 +1,112 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef _GPIO_WIRE_CLIENT_HPP_
+#define _GPIO_WIRE_CLIENT_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include <GPIOWireProtocol.hpp>
+#include <GPIOWireSession.hpp>
+
+using namespace std;
+
+// gpiowired client: SendMessage() is a drop-in replacement of the
+// CGPIOWire one (the daemon owns the devices, so many processes can share
+// them). High rate clients can attach a shared memory ring and post frames
+// without any system call but the daemon wake up. Not thread safe: use one
+// client per thread.
+
+class CGPIOWireClient
+{
+public:
+  CGPIOWireClient(
+    unsigned short uiDeviceNumber,
+    const string&  sSocket = DEF_GPIOWIRED_SOCKET
+  );
+
+  ~CGPIOWireClient();
+
+  CGPIOWireClient(const CGPIOWireClient&)            = delete;
+  CGPIOWireClient& operator=(const CGPIOWireClient&) = delete;
+
+  // True when the daemon is reachable.
+
+  bool Exists();
+
+  // 0 (lowest, default) to DEF_GPIOWIRED_PRIORITIES - 1 (highest).
+
+  void SetPriority(unsigned int uiPriority);
+
+  // Blocks until the daemon has sent the frame.
+
+  bool SendMessage(const unsigned char* lpMessage, size_t nSize);
+
+  SGPIOWireResult GetLastResult() const;
+
+  // Shared memory fast path: PostMessage() copies the frame into the ring
+  // (false when full), Flush() waits (iTimeout mS, -1 = forever) until the
+  // daemon has processed every posted frame.
+
+  bool     Attach(size_t nRingSize = DEF_GPIOWIRED_RING_SIZE);
+  bool     PostMessage(const unsigned char* lpMessage, size_t nSize);
+  bool     Flush(int iTimeout = -1);
+  uint64_t GetFailedCount() const;
+
+  // Per client statistics, as text (empty on failure).
+
+  string GetStatistics();
+
+private:
+  unsigned short  m_uiDeviceNumber;
+  string          m_sSocket;
+  unsigned int    m_uiPriority;
+  int             m_iSocket;
+  uint32_t        m_uiSequence;
+  SGPIOWireResult m_LastResult;
+
+  SGPIOWireRing*  m_lpRing;
+  size_t          m_nRingMapSize;
+  int             m_iDoorbell;
+  int             m_iCompletion;
+  uint64_t        m_ulPosted;
+
+  vector<unsigned char> m_lpPacket;
+
+  bool Connect();
+  void Disconnect();
+  bool Request(
+    const SGPIOWireRequest& Request,
+    const unsigned char*    lpData,
+    size_t                  nSize,
+    const int*              lpFiles,
+    size_t                  nFiles,
+    string*                 lpsText,
+    int*                    lpReplyFiles  = NULL,
+    size_t                  nReplyFiles   = 0
+  );
+  bool SetResult(int iError, const char* lpszOperation);
+};
+
+#endif /* _GPIO_WIRE_CLIENT_HPP_ */
@@ -0,0 +1,198 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <assert.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+#include "GPIOWireCoroutine.hpp"
+
+/*****************/
+/* CGPIOWireTask */
+/*****************/
+
+CGPIOWireTask::promise_type::~promise_type()
+{
+  if (lpExecutor)
+  {
+    lpExecutor->m_nTasks--;
+  }
+}
+
+CGPIOWireTask::CGPIOWireTask(coroutine_handle<promise_type> Handle)
+  : m_Handle(Handle)
+{
+}
+
+CGPIOWireTask::CGPIOWireTask(CGPIOWireTask&& Task) noexcept
+  : m_Handle(Task.m_Handle)
+{
+  Task.m_Handle = NULL;
+}
+
+CGPIOWireTask::~CGPIOWireTask()
+{
+  // Never spawned
+
+  if (m_Handle)
+  {
+    m_Handle.destroy();
+  }
+}
+
+/*********************/
+/* CGPIOWireExecutor */
+/*********************/
+
+CGPIOWireExecutor::CGPIOWireExecutor()
+  : m_iEpoll(epoll_create1(EPOLL_CLOEXEC))
+  , m_iEvent(eventfd(0, (EFD_CLOEXEC | EFD_NONBLOCK)))
+  , m_nTasks(0)
+{
+  assert(-1 != m_iEpoll);
+  assert(-1 != m_iEvent);
+
+  struct epoll_event Event = {};
+
+  Event.events  = EPOLLIN;
+  Event.data.fd = m_iEvent;
+
+  epoll_ctl(m_iEpoll, EPOLL_CTL_ADD, m_iEvent, &Event);
+}
+
+CGPIOWireExecutor::~CGPIOWireExecutor()
+{
+  close(m_iEvent);
+  close(m_iEpoll);
+}
+
+void CGPIOWireExecutor::Spawn(CGPIOWireTask&& Task)
+{
+  assert(Task.m_Handle);
+
+  Task.m_Handle.promise().lpExecutor = this;
+  m_nTasks++;
+
+  Post(Task.m_Handle);
+
+  Task.m_Handle = NULL;
+}
+
+void CGPIOWireExecutor::Post(coroutine_handle<> Handle)
+{
+  {
+    lock_guard<mutex> Lock(m_ReadyMutex);
+
+    m_lpReady.push_back(Handle);
+  }
+
+  uint64_t ulValue = 1;
+
+  if (write(m_iEvent, &ulValue, sizeof(ulValue))) {}
+}
+
+void CGPIOWireExecutor::Run()
+{
+  while (m_nTasks > 0)
+  {
+    {
+      lock_guard<mutex> Lock(m_ReadyMutex);
+
+      m_lpRunning.swap(m_lpReady);
+    }
+
+    if (m_lpRunning.empty())
+    {
+      Wait();
+      continue;
+    }
+
+    for (size_t nIndex = 0; nIndex < m_lpRunning.size(); nIndex++)
+    {
+      m_lpRunning[nIndex].resume();
+    }
+
+    m_lpRunning.clear();
+  }
+}
+
+void CGPIOWireExecutor::Wait()
+{
+  struct epoll_event Event;
+
+  if (1 == epoll_wait(m_iEpoll, &Event, 1, -1))
+  {
+    uint64_t ulValue;
+
+    if (read(m_iEvent, &ulValue, sizeof(ulValue))) {}
+  }
+}
+
+/******************/
+/* CGPIOWireAsync */
+/******************/
+
+CGPIOWireAsync::CSendAwaiter::CSendAwaiter(
+  CGPIOWireAsync&      Wire,
+  const unsigned char* lpMessage,
+  size_t               nSize
+)
+  : m_Wire(Wire)
+  , m_lpMessage(lpMessage)
+  , m_nSize(nSize)
+  , m_Report({ { 0, NULL, 0 }, 0 })
+{
+}
+
+void CGPIOWireAsync::CSendAwaiter::await_suspend(coroutine_handle<> Handle)
+{
+  // Completed on the writer thread (or at once when the queue is full), and
+  // resumed by the executor in any case.
+
+  m_Wire.m_Sender.SendMessage(
+    m_lpMessage,
+    m_nSize,
+    [this, Handle](const SGPIOWireSendReport& Report)
+    {
+      m_Report = Report;
+      m_Wire.m_Executor.Post(Handle);
+    }
+  );
+}
+
+CGPIOWireAsync::CGPIOWireAsync(
+  CGPIOWireExecutor& Executor,
+  CGPIOWireSession&& Session,
+  size_t             nMaxDepth
+)
+  : m_Executor(Executor)
+  , m_Sender(move(Session), nMaxDepth)
+{
+}
+
+CGPIOWireAsync::CSendAwaiter CGPIOWireAsync::Send(
+  const unsigned char* lpMessage,
+  size_t               nSize
+)
+{
+  return CSendAwaiter(*this, lpMessage, nSize);
+}
@@ -0,0 +1,168 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef _GPIO_WIRE_COROUTINE_HPP_
+#define _GPIO_WIRE_COROUTINE_HPP_
+
+#include <stddef.h>
+
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <vector>
+
+#include <GPIOWireSender.hpp>
+#include <GPIOWireSession.hpp>
+
+using namespace std;
+
+// Coroutine interface, e.g.:
+//
+//   CGPIOWireTask Send(CGPIOWireAsync& Wire)
+//   {
+//     SGPIOWireSendReport Report = co_await Wire.Send(lpFrame, nSize);
+//   }
+//
+//   CGPIOWireExecutor Executor;
+//   CGPIOWireAsync    Wire(Executor, GPIOWire.OpenSession(), 64);
+//
+//   Executor.Spawn(Send(Wire));
+//   Executor.Run();
+//
+// The module write blocks for the whole air time, so sends complete on the
+// CGPIOWireSender writer thread, which hands the waiting coroutine back to
+// the executor: any number of coroutines wait without threads of their own.
+
+class CGPIOWireExecutor;
+
+// Fire and forget task, started by CGPIOWireExecutor::Spawn().
+
+class CGPIOWireTask
+{
+public:
+  struct promise_type
+  {
+    CGPIOWireExecutor* lpExecutor = NULL;
+
+    ~promise_type();
+
+    CGPIOWireTask get_return_object()
+    {
+      return CGPIOWireTask(coroutine_handle<promise_type>::from_promise(*this));
+    }
+
+    suspend_always initial_suspend() noexcept { return {}; }
+    suspend_never  final_suspend()   noexcept { return {}; }
+
+    void return_void() {}
+    void unhandled_exception() { terminate(); }
+  };
+
+  CGPIOWireTask(CGPIOWireTask&& Task) noexcept;
+  ~CGPIOWireTask();
+
+  CGPIOWireTask(const CGPIOWireTask&)            = delete;
+  CGPIOWireTask& operator=(const CGPIOWireTask&) = delete;
+
+private:
+  friend class CGPIOWireExecutor;
+
+  coroutine_handle<promise_type> m_Handle;
+
+  explicit CGPIOWireTask(coroutine_handle<promise_type> Handle);
+};
+
+// Single threaded executor: resumes coroutines posted by any thread, waking
+// up by an eventfd watched through epoll.
+
+class CGPIOWireExecutor
+{
+public:
+  CGPIOWireExecutor();
+  ~CGPIOWireExecutor();
+
+  CGPIOWireExecutor(const CGPIOWireExecutor&)            = delete;
+  CGPIOWireExecutor& operator=(const CGPIOWireExecutor&) = delete;
+
+  void Spawn(CGPIOWireTask&& Task);
+
+  // Thread safe.
+
+  void Post(coroutine_handle<> Handle);
+
+  // Runs until every spawned task has completed.
+
+  void Run();
+
+private:
+  friend struct CGPIOWireTask::promise_type;
+
+  int                        m_iEpoll;
+  int                        m_iEvent;
+  size_t                     m_nTasks;
+  mutex                      m_ReadyMutex;
+  vector<coroutine_handle<>> m_lpReady;
+  vector<coroutine_handle<>> m_lpRunning;
+
+  void Wait();
+};
+
+// Awaitable sender on top of CGPIOWireSender.
+
+class CGPIOWireAsync
+{
+public:
+  class CSendAwaiter
+  {
+  public:
+    CSendAwaiter(
+      CGPIOWireAsync&      Wire,
+      const unsigned char* lpMessage,
+      size_t               nSize
+    );
+
+    bool                await_ready() const noexcept { return false; }
+    void                await_suspend(coroutine_handle<> Handle);
+    SGPIOWireSendReport await_resume() const noexcept { return m_Report; }
+
+  private:
+    CGPIOWireAsync&      m_Wire;
+    const unsigned char* m_lpMessage;
+    size_t               m_nSize;
+    SGPIOWireSendReport  m_Report;
+  };
+
+  CGPIOWireAsync(
+    CGPIOWireExecutor&  Executor,
+    CGPIOWireSession&&  Session,
+    size_t              nMaxDepth
+  );
+
+  // The frame is copied at once: the caller buffer may be reused after the
+  // co_await suspends. A full queue resumes with EAGAIN.
+
+  CSendAwaiter Send(const unsigned char* lpMessage, size_t nSize);
+
+private:
+  CGPIOWireExecutor& m_Executor;
+  CGPIOWireSender    m_Sender;
+};
+
+#endif /* _GPIO_WIRE_COROUTINE_HPP_ */
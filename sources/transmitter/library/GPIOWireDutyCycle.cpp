@@ -0,0 +1,277 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "GPIOWireDutyCycle.hpp"
+
+#define DUTY_CYCLE_STATE_HEADER "gpiowire-duty-cycle 1"
+
+CGPIOWireDutyCycle::CGPIOWireDutyCycle(
+  double        dDutyCycle,
+  unsigned long ulWindow,
+  const string& sStateFile
+)
+  : m_ulBudget((uint64_t)(dDutyCycle * ulWindow * 1000000.0))
+  , m_ulWindow((uint64_t)ulWindow * 1000000)
+  , m_ulSpent(0)
+  , m_sStateFile(sStateFile)
+{
+  assert((dDutyCycle > 0.0) && (dDutyCycle <= 1.0));
+  assert(ulWindow > 0);
+
+  if (!m_sStateFile.empty())
+  {
+    Load();
+  }
+}
+
+uint64_t CGPIOWireDutyCycle::GetBudget() const
+{
+  return m_ulBudget;
+}
+
+uint64_t CGPIOWireDutyCycle::GetAvailable()
+{
+  lock_guard<mutex> Lock(m_Mutex);
+
+  Expire(GetTime());
+
+  return ((m_ulSpent >= m_ulBudget) ? 0 : (m_ulBudget - m_ulSpent));
+}
+
+uint64_t CGPIOWireDutyCycle::GetDelay(unsigned long ulAirTime)
+{
+  lock_guard<mutex> Lock(m_Mutex);
+
+  uint64_t ulNow = GetTime();
+
+  Expire(ulNow);
+
+  return GetDelay(ulNow, ulAirTime);
+}
+
+uint64_t CGPIOWireDutyCycle::Admit(unsigned long ulAirTime)
+{
+  lock_guard<mutex> Lock(m_Mutex);
+
+  uint64_t ulNow = GetTime();
+
+  Expire(ulNow);
+
+  uint64_t ulDelay = GetDelay(ulNow, ulAirTime);
+
+  if (0 == ulDelay)
+  {
+    m_lpEntries.push_back({ ulNow, ulAirTime });
+    m_ulSpent += ulAirTime;
+
+    if (!m_sStateFile.empty())
+    {
+      Save();
+    }
+  }
+
+  return ulDelay;
+}
+
+uint64_t CGPIOWireDutyCycle::Admit(
+  CGPIOWire&           GPIOWire,
+  const unsigned char* lpMessage,
+  size_t               nSize
+)
+{
+  return Admit(GPIOWire.GetOnAirTime(lpMessage, nSize));
+}
+
+bool CGPIOWireDutyCycle::Acquire(unsigned long ulAirTime)
+{
+  for (;;)
+  {
+    uint64_t ulDelay = Admit(ulAirTime);
+
+    if (0 == ulDelay)
+    {
+      return true;
+    }
+
+    if (UINT64_MAX == ulDelay)
+    {
+      return false;
+    }
+
+    struct timespec Delay = {
+      (time_t)(ulDelay / 1000000),
+      (long)((ulDelay % 1000000) * 1000)
+    };
+
+    clock_nanosleep(CLOCK_MONOTONIC, 0, &Delay, NULL);
+  }
+}
+
+bool CGPIOWireDutyCycle::Acquire(
+  CGPIOWire&           GPIOWire,
+  const unsigned char* lpMessage,
+  size_t               nSize
+)
+{
+  return Acquire(GPIOWire.GetOnAirTime(lpMessage, nSize));
+}
+
+uint64_t CGPIOWireDutyCycle::GetTime()
+{
+  struct timespec Time;
+
+  clock_gettime(CLOCK_REALTIME, &Time);
+
+  return ((uint64_t)Time.tv_sec * 1000000) + (Time.tv_nsec / 1000);
+}
+
+void CGPIOWireDutyCycle::Expire(uint64_t ulNow)
+{
+  // Tokens come back one window after they were spent (entries stamped in
+  // the future, after a clock step back, are kept until then)
+
+  while (
+       !m_lpEntries.empty()
+    && ((m_lpEntries.front().ulTime + m_ulWindow) <= ulNow)
+  )
+  {
+    m_ulSpent -= m_lpEntries.front().ulAirTime;
+    m_lpEntries.pop_front();
+  }
+}
+
+uint64_t CGPIOWireDutyCycle::GetDelay(
+  uint64_t      ulNow,
+  unsigned long ulAirTime
+) const
+{
+  if (ulAirTime > m_ulBudget)
+  {
+    return UINT64_MAX;
+  }
+
+  uint64_t ulSpent = m_ulSpent;
+
+  if ((ulSpent + ulAirTime) <= m_ulBudget)
+  {
+    return 0;
+  }
+
+  // Wait for enough tokens to come back (maybe more than the budget, when
+  // over spent)
+
+  for (size_t nIndex = 0; nIndex < m_lpEntries.size(); nIndex++)
+  {
+    ulSpent -= m_lpEntries[nIndex].ulAirTime;
+
+    if ((ulSpent + ulAirTime) <= m_ulBudget)
+    {
+      uint64_t ulReturn = (m_lpEntries[nIndex].ulTime + m_ulWindow);
+
+      return ((ulReturn > ulNow) ? (ulReturn - ulNow) : 1);
+    }
+  }
+
+  return UINT64_MAX; // Not reached
+}
+
+bool CGPIOWireDutyCycle::Load()
+{
+  FILE* lpFile = fopen(m_sStateFile.c_str(), "r");
+
+  if (!lpFile)
+  {
+    return false;
+  }
+
+  char               szHeader[32];
+  unsigned long long ullTime;
+  unsigned long      ulAirTime;
+
+  bool bResult = (
+       fgets(szHeader, sizeof(szHeader), lpFile)
+    && (0 == strcmp(szHeader, DUTY_CYCLE_STATE_HEADER "\n"))
+  );
+
+  while (bResult && (2 == fscanf(lpFile, "%llu %lu", &ullTime, &ulAirTime)))
+  {
+    m_lpEntries.push_back({ (uint64_t)ullTime, ulAirTime });
+    m_ulSpent += ulAirTime;
+  }
+
+  fclose(lpFile);
+
+  // Written with a larger budget maybe: all of it was really sent, so it is
+  // kept until it expires (GetAvailable() is 0 meanwhile)
+
+  Expire(GetTime());
+
+  return bResult;
+}
+
+bool CGPIOWireDutyCycle::Save() const
+{
+  // Synced then renamed over the previous state, so a crash never leaves a
+  // truncated one behind
+
+  string sTemporary = (m_sStateFile + ".tmp");
+  FILE*  lpFile     = fopen(sTemporary.c_str(), "w");
+
+  if (!lpFile)
+  {
+    return false;
+  }
+
+  bool bResult = (fprintf(lpFile, DUTY_CYCLE_STATE_HEADER "\n") > 0);
+
+  for (size_t nIndex = 0; bResult && (nIndex < m_lpEntries.size()); nIndex++)
+  {
+    bResult = (
+      fprintf(
+        lpFile,
+        "%llu %lu\n",
+        (unsigned long long)m_lpEntries[nIndex].ulTime,
+        m_lpEntries[nIndex].ulAirTime
+      ) > 0
+    );
+  }
+
+  bResult = (
+       bResult
+    && (0 == fflush(lpFile))
+    && (0 == fsync(fileno(lpFile)))
+  );
+  bResult = ((0 == fclose(lpFile)) && bResult);
+
+  if (!bResult || (0 != rename(sTemporary.c_str(), m_sStateFile.c_str())))
+  {
+    remove(sTemporary.c_str());
+
+    return false;
+  }
+
+  return true;
+}
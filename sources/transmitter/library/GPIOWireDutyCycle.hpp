@@ -0,0 +1,107 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef _GPIO_WIRE_DUTY_CYCLE_HPP_
+#define _GPIO_WIRE_DUTY_CYCLE_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <deque>
+#include <mutex>
+#include <string>
+
+#include <GPIOWire.hpp>
+
+using namespace std;
+
+// Duty cycle air time accountant (e.g. 1% per hour): a token bucket holding
+// the whole window budget, where each spent token comes back exactly one
+// window after its frame was admitted. Thus no sliding window ever goes over
+// the budget, while all of it can be used (bursts included).
+//
+// Frames are accounted for by their time on air, repeat gaps excluded
+// (CGPIOWire::GetOnAirTime()). Spent air time is stamped by the wall clock
+// and, when a state file is given, saved on each admission and loaded back on
+// construction, so that restarts do not reset the budget (a state spent over
+// a smaller budget is kept whole: nothing is available until it expires).
+
+class CGPIOWireDutyCycle
+{
+public:
+  CGPIOWireDutyCycle(
+    double        dDutyCycle,          // 0.01 = 1%
+    unsigned long ulWindow   = 3600,   // S
+    const string& sStateFile = ""
+  );
+
+  CGPIOWireDutyCycle(const CGPIOWireDutyCycle&)            = delete;
+  CGPIOWireDutyCycle& operator=(const CGPIOWireDutyCycle&) = delete;
+
+  uint64_t GetBudget() const;  // uS per window
+  uint64_t GetAvailable();     // uS, 0 when over spent
+
+  // Delay (uS) before ulAirTime fits the budget, UINT64_MAX when it never
+  // will (longer than the whole budget).
+
+  uint64_t GetDelay(unsigned long ulAirTime);
+
+  // Spends ulAirTime if it fits the budget now (returning 0), otherwise
+  // returns the delay as GetDelay() does.
+
+  uint64_t Admit(unsigned long ulAirTime);
+  uint64_t Admit(
+    CGPIOWire&           GPIOWire,
+    const unsigned char* lpMessage,
+    size_t               nSize
+  );
+
+  // Blocking version of Admit(): false when ulAirTime never fits.
+
+  bool Acquire(unsigned long ulAirTime);
+  bool Acquire(
+    CGPIOWire&           GPIOWire,
+    const unsigned char* lpMessage,
+    size_t               nSize
+  );
+
+  static uint64_t GetTime(); // Wall clock, uS
+
+private:
+  struct SEntry
+  {
+    uint64_t      ulTime;
+    unsigned long ulAirTime;
+  };
+
+  mutable mutex  m_Mutex;
+  uint64_t       m_ulBudget;
+  uint64_t       m_ulWindow;
+  uint64_t       m_ulSpent;
+  deque<SEntry>  m_lpEntries;
+  string         m_sStateFile;
+
+  void     Expire(uint64_t ulNow);
+  uint64_t GetDelay(uint64_t ulNow, unsigned long ulAirTime) const;
+  bool     Load();
+  bool     Save() const;
+};
+
+#endif /* _GPIO_WIRE_DUTY_CYCLE_HPP_ */
@@ -0,0 +1,586 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#ifdef GPIOWIRE_LIBGPIOD
+#include <gpiod.h>
+#else
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+#endif
+
+#include <algorithm>
+
+#include "GPIOWireLine.hpp"
+
+#define LINE_STACK_PREFAULT 65536
+
+static uint64_t GetTime()
+{
+  struct timespec Time;
+
+  clock_gettime(CLOCK_MONOTONIC, &Time);
+
+  return ((uint64_t)Time.tv_sec * 1000000000) + Time.tv_nsec;
+}
+
+CGPIOWireLine::CGPIOWireLine(
+  const string&            sChip,
+  unsigned int             uiOffset,
+  const SGPIOWireLineCode& LineCode,
+  bool                     bSwapOutput,
+  int                      iPriority,
+  unsigned long            ulSpinTime,
+  bool                     bLockMemory
+)
+  : m_LineCode(LineCode)
+  , m_uiOffset(uiOffset)
+  , m_ulSpinTime(ulSpinTime)
+  , m_bRealTime(false)
+  , m_LastResult({ 0, NULL, 0 })
+#ifdef GPIOWIRE_LIBGPIOD
+  , m_lpRequest(NULL)
+#else
+  , m_iLine(-1)
+#endif
+  , m_bPending(false)
+  , m_bStop(false)
+  , m_nPlayed(0)
+  , m_iError(0)
+{
+  if (!Open(sChip, bSwapOutput))
+  {
+    return;
+  }
+
+  m_Transmitter = thread(&CGPIOWireLine::Run, this);
+
+  if (iPriority > 0)
+  {
+    // Page faults and preemption by normal tasks are the largest edge
+    // delays: both need privileges (CAP_IPC_LOCK, CAP_SYS_NICE). The whole
+    // process is locked on request only.
+
+    struct sched_param Param = {};
+
+    Param.sched_priority = iPriority;
+
+    bool bLocked = (!bLockMemory || (0 == mlockall(MCL_CURRENT | MCL_FUTURE)));
+    bool bFIFO   = (0 == pthread_setschedparam(
+      m_Transmitter.native_handle(),
+      SCHED_FIFO,
+      &Param
+    ));
+
+    m_bRealTime = (bLocked && bFIFO);
+  }
+}
+
+CGPIOWireLine::~CGPIOWireLine()
+{
+  {
+    lock_guard<mutex> Lock(m_Mutex);
+
+    m_bStop = true;
+  }
+
+  m_Signal.notify_all();
+
+  if (m_Transmitter.joinable())
+  {
+    m_Transmitter.join();
+  }
+
+  Close();
+}
+
+bool CGPIOWireLine::IsOpen() const
+{
+#ifdef GPIOWIRE_LIBGPIOD
+  return (NULL != m_lpRequest);
+#else
+  return (-1 != m_iLine);
+#endif
+}
+
+bool CGPIOWireLine::IsRealTime() const
+{
+  return m_bRealTime;
+}
+
+SGPIOWireResult CGPIOWireLine::GetLastResult() const
+{
+  lock_guard<mutex> Lock(m_Mutex);
+
+  return m_LastResult;
+}
+
+SGPIOWireResult CGPIOWireLine::SendMessage(
+  const unsigned char* lpMessage,
+  size_t               nSize
+)
+{
+  return SendMessages(&lpMessage, &nSize, 1);
+}
+
+SGPIOWireResult CGPIOWireLine::SendMessages(
+  const unsigned char* const* lpMessages,
+  const size_t*               lpSizes,
+  size_t                      nCount
+)
+{
+  assert(lpMessages);
+  assert(lpSizes);
+
+  lock_guard<mutex>  Send(m_SendMutex);
+  unique_lock<mutex> Lock(m_Mutex);
+
+  if (!IsOpen())
+  {
+    return SetResult(EBADF, "set", 0);
+  }
+
+  if (!nCount)
+  {
+    return SetResult(0, NULL, 0);
+  }
+
+  // Compiled before playing, the transmitter thread does not allocate
+
+  CreateSchedule(
+    m_LineCode,
+    lpMessages,
+    lpSizes,
+    nCount,
+    m_lpSchedule,
+    m_lpFrameEnds
+  );
+
+  m_lpLateness.resize(m_lpSchedule.size());
+
+  m_bPending = true;
+  m_Signal.notify_all();
+  m_Signal.wait(Lock, [this] { return !m_bPending; });
+
+  if (!m_iError)
+  {
+    return SetResult(0, NULL, nCount);
+  }
+
+  size_t nFrames = 0;
+
+  while ((nFrames < nCount) && (m_nPlayed > m_lpFrameEnds[nFrames]))
+  {
+    nFrames++;
+  }
+
+  return SetResult(m_iError, "set", nFrames);
+}
+
+SGPIOWireJitter CGPIOWireLine::GetJitter() const
+{
+  SGPIOWireJitter    Jitter = { 0, 0, 0, 0 };
+  unique_lock<mutex> Lock(m_Mutex);
+
+  m_Signal.wait(Lock, [this] { return !m_bPending; });
+
+  // Initial low level excluded
+
+  if (m_nPlayed < 2)
+  {
+    return Jitter;
+  }
+
+  vector<uint32_t> lpLateness(
+    m_lpLateness.begin(),
+    (m_lpLateness.begin() + (m_nPlayed - 1))
+  );
+
+  uint64_t ulTotal = 0;
+
+  for (size_t nIndex = 0; nIndex < lpLateness.size(); nIndex++)
+  {
+    ulTotal      += lpLateness[nIndex];
+    Jitter.ulMax  = max(Jitter.ulMax, (uint64_t)lpLateness[nIndex]);
+  }
+
+  size_t nP99 = ((lpLateness.size() * 99) / 100);
+
+  nth_element(lpLateness.begin(), (lpLateness.begin() + nP99), lpLateness.end());
+
+  Jitter.nEdges = lpLateness.size();
+  Jitter.ulMean = (ulTotal / lpLateness.size());
+  Jitter.ulP99  = lpLateness[nP99];
+
+  return Jitter;
+}
+
+void CGPIOWireLine::CreateSchedule(
+  const SGPIOWireLineCode&    LineCode,
+  const unsigned char* const* lpMessages,
+  const size_t*               lpSizes,
+  size_t                      nCount,
+  vector<uint32_t>&           lpSchedule,
+  vector<size_t>&             lpFrameEnds
+)
+{
+  uint32_t uiHigh = LineCode.ulHighStateEdge;
+
+  lpSchedule.clear();
+  lpFrameEnds.clear();
+
+  // Lead in, as the module timer is started
+
+  lpSchedule.push_back(uiHigh);
+
+  for (size_t nFrame = 0; nFrame < nCount; nFrame++)
+  {
+    for (unsigned long ulCopy = 0; ulCopy <= LineCode.ulRepeatCount; ulCopy++)
+    {
+      if (ulCopy)
+      {
+        lpSchedule.push_back(LineCode.ulRepeatGap);
+      }
+      else if (nFrame)
+      {
+        lpSchedule.push_back(LineCode.ulFrameGap);
+      }
+
+      for (size_t nIndex = 0; nIndex < lpSizes[nFrame]; nIndex++)
+      {
+        // Each pulse is a high state edge plus the low state rest
+
+        if (
+             !LineCode.bFrameSync
+          || (0 == nIndex)
+          || (
+                  (LineCode.ulResyncInterval > 0)
+               && (0 == (nIndex % LineCode.ulResyncInterval))
+             )
+        )
+        {
+          for (unsigned long ulBit = 0; ulBit < LineCode.ulSyncBitCount; ulBit++)
+          {
+            lpSchedule.push_back(uiHigh);
+            lpSchedule.push_back(LineCode.ulBitSyncDuration - uiHigh);
+          }
+        }
+
+        unsigned char nByte = lpMessages[nFrame][nIndex];
+
+        if (LineCode.bMultiLevel)
+        {
+          for (int iSymbol = 0; iSymbol < 4; iSymbol++, nByte <<= 2)
+          {
+            unsigned long ulDuration;
+
+            switch (nByte & 0xC0)
+            {
+              case 0x00: ulDuration = LineCode.ulBitZeroDuration;     break;
+              case 0x40: ulDuration = LineCode.ulBitOneDuration;      break;
+              case 0x80: ulDuration = LineCode.ulSymbolTwoDuration;   break;
+              default:   ulDuration = LineCode.ulSymbolThreeDuration; break;
+            }
+
+            lpSchedule.push_back(uiHigh);
+            lpSchedule.push_back(ulDuration - uiHigh);
+          }
+        }
+        else
+        {
+          for (int iBit = 0; iBit < 8; iBit++, nByte <<= 1)
+          {
+            lpSchedule.push_back(uiHigh);
+            lpSchedule.push_back(
+                (
+                    (nByte & 0x80)
+                  ? LineCode.ulBitOneDuration
+                  : LineCode.ulBitZeroDuration
+                )
+              - uiHigh
+            );
+          }
+        }
+      }
+
+      // Closing high edge
+
+      lpSchedule.push_back(uiHigh);
+    }
+
+    lpFrameEnds.push_back(lpSchedule.size());
+  }
+}
+
+bool CGPIOWireLine::Open(const string& sChip, bool bSwapOutput)
+{
+#ifdef GPIOWIRE_LIBGPIOD
+  struct gpiod_chip* lpChip = gpiod_chip_open(sChip.c_str());
+
+  if (!lpChip)
+  {
+    SetResult(errno, "open", 0);
+    return false;
+  }
+
+  struct gpiod_line_settings*  lpSettings      = gpiod_line_settings_new();
+  struct gpiod_line_config*    lpLineConfig    = gpiod_line_config_new();
+  struct gpiod_request_config* lpRequestConfig = gpiod_request_config_new();
+
+  if (lpSettings && lpLineConfig && lpRequestConfig)
+  {
+    // Swapped output as active low, as the module does
+
+    gpiod_line_settings_set_direction(lpSettings, GPIOD_LINE_DIRECTION_OUTPUT);
+    gpiod_line_settings_set_output_value(lpSettings, GPIOD_LINE_VALUE_INACTIVE);
+    gpiod_line_settings_set_active_low(lpSettings, bSwapOutput);
+
+    gpiod_request_config_set_consumer(lpRequestConfig, DEF_GPIO_LINE_CONSUMER);
+
+    if (0 == gpiod_line_config_add_line_settings(lpLineConfig, &m_uiOffset, 1, lpSettings))
+    {
+      m_lpRequest = gpiod_chip_request_lines(lpChip, lpRequestConfig, lpLineConfig);
+    }
+  }
+
+  int iError = (errno ? errno : ENOMEM);
+
+  if (lpRequestConfig)
+  {
+    gpiod_request_config_free(lpRequestConfig);
+  }
+
+  if (lpLineConfig)
+  {
+    gpiod_line_config_free(lpLineConfig);
+  }
+
+  if (lpSettings)
+  {
+    gpiod_line_settings_free(lpSettings);
+  }
+
+  gpiod_chip_close(lpChip);
+
+  if (!m_lpRequest)
+  {
+    SetResult(iError, "request", 0);
+    return false;
+  }
+#else
+  int iChip = open(sChip.c_str(), (O_RDWR | O_CLOEXEC));
+
+  if (-1 == iChip)
+  {
+    SetResult(errno, "open", 0);
+    return false;
+  }
+
+  struct gpio_v2_line_request Request;
+
+  memset(&Request, 0, sizeof(Request));
+
+  Request.offsets[0] = m_uiOffset;
+  Request.num_lines  = 1;
+
+  strncpy(Request.consumer, DEF_GPIO_LINE_CONSUMER, (sizeof(Request.consumer) - 1));
+
+  // Swapped output as active low, as the module does, starting low
+
+  Request.config.flags = (
+      GPIO_V2_LINE_FLAG_OUTPUT
+    | (bSwapOutput ? GPIO_V2_LINE_FLAG_ACTIVE_LOW : 0)
+  );
+
+  Request.config.num_attrs            = 1;
+  Request.config.attrs[0].attr.id     = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+  Request.config.attrs[0].attr.values = 0;
+  Request.config.attrs[0].mask        = 1;
+
+  int iResult = ioctl(iChip, GPIO_V2_GET_LINE_IOCTL, &Request);
+  int iError  = errno;
+
+  close(iChip);
+
+  if (-1 == iResult)
+  {
+    SetResult(iError, "request", 0);
+    return false;
+  }
+
+  m_iLine = Request.fd;
+#endif
+
+  SetResult(0, NULL, 0);
+  return true;
+}
+
+void CGPIOWireLine::Close()
+{
+#ifdef GPIOWIRE_LIBGPIOD
+  if (m_lpRequest)
+  {
+    gpiod_line_request_release(m_lpRequest);
+    m_lpRequest = NULL;
+  }
+#else
+  if (-1 != m_iLine)
+  {
+    close(m_iLine);
+    m_iLine = -1;
+  }
+#endif
+}
+
+bool CGPIOWireLine::SetValue(bool bValue)
+{
+#ifdef GPIOWIRE_LIBGPIOD
+  return (
+    0 == gpiod_line_request_set_value(
+      m_lpRequest,
+      m_uiOffset,
+      (bValue ? GPIOD_LINE_VALUE_ACTIVE : GPIOD_LINE_VALUE_INACTIVE)
+    )
+  );
+#else
+  struct gpio_v2_line_values Values;
+
+  Values.bits = (bValue ? 1 : 0);
+  Values.mask = 1;
+
+  return (-1 != ioctl(m_iLine, GPIO_V2_LINE_SET_VALUES_IOCTL, &Values));
+#endif
+}
+
+void CGPIOWireLine::Run()
+{
+  // Stack pages touched once, so that playing does not fault them in
+
+  volatile unsigned char lpStack[LINE_STACK_PREFAULT];
+
+  for (size_t nIndex = 0; nIndex < sizeof(lpStack); nIndex += 4096)
+  {
+    lpStack[nIndex] = 0;
+  }
+
+  unique_lock<mutex> Lock(m_Mutex);
+
+  for (;;)
+  {
+    m_Signal.wait(Lock, [this] { return (m_bPending || m_bStop); });
+
+    if (m_bStop)
+    {
+      break;
+    }
+
+    Lock.unlock();
+
+    Play();
+
+    Lock.lock();
+
+    m_bPending = false;
+    m_Signal.notify_all();
+  }
+}
+
+void CGPIOWireLine::Play()
+{
+  m_nPlayed = 0;
+  m_iError  = 0;
+
+  if (!SetValue(false))
+  {
+    m_iError = errno;
+    return;
+  }
+
+  m_nPlayed = 1;
+
+  // Absolute edge times: a late edge does not shift the following ones
+
+  uint64_t ulDeadline = GetTime();
+  bool     bLevel     = false;
+
+  for (size_t nIndex = 0; nIndex < m_lpSchedule.size(); nIndex++)
+  {
+    ulDeadline += ((uint64_t)m_lpSchedule[nIndex] * 1000);
+
+    Wait(ulDeadline);
+
+    bLevel = !bLevel;
+
+    if (!SetValue(bLevel))
+    {
+      m_iError = errno;
+
+      SetValue(false);
+      return;
+    }
+
+    uint64_t ulLateness = (GetTime() - ulDeadline);
+
+    m_lpLateness[nIndex] = (uint32_t)min(ulLateness, (uint64_t)UINT32_MAX);
+    m_nPlayed++;
+  }
+}
+
+void CGPIOWireLine::Wait(uint64_t ulDeadline)
+{
+  // Sleeps until the spin time before the edge, then busy waits (the wake
+  // up latency is paid before the deadline)
+
+  uint64_t        ulWakeUp = (ulDeadline - min(ulDeadline, (uint64_t)m_ulSpinTime * 1000));
+  struct timespec Time;
+
+  Time.tv_sec  = (ulWakeUp / 1000000000);
+  Time.tv_nsec = (ulWakeUp % 1000000000);
+
+  while (EINTR == clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &Time, NULL))
+  {
+  }
+
+  while (m_ulSpinTime && (GetTime() < ulDeadline))
+  {
+  }
+}
+
+SGPIOWireResult CGPIOWireLine::SetResult(
+  int         iError,
+  const char* lpszOperation,
+  size_t      nFrames
+)
+{
+  m_LastResult.iError        = iError;
+  m_LastResult.lpszOperation = (iError ? lpszOperation : NULL);
+  m_LastResult.nFrames       = nFrames;
+
+  return m_LastResult;
+}
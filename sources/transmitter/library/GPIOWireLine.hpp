@@ -0,0 +1,166 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef _GPIO_WIRE_LINE_HPP_
+#define _GPIO_WIRE_LINE_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <GPIOWire.hpp>
+#include <GPIOWireSession.hpp>
+
+using namespace std;
+
+#define DEF_GPIO_LINE_CONSUMER  "gpiowire"
+#define DEF_GPIO_LINE_PRIORITY  80 // SCHED_FIFO, 0 = normal scheduling
+#define DEF_GPIO_LINE_SPIN_TIME 0  // uS busy waited before each edge
+
+#ifdef GPIOWIRE_LIBGPIOD
+struct gpiod_line_request;
+#endif
+
+// Edge lateness (nS) of the last send: time the line was set after the edge
+// was due.
+
+struct SGPIOWireJitter
+{
+  size_t   nEdges;
+  uint64_t ulMean;
+  uint64_t ulP99;
+  uint64_t ulMax;
+};
+
+// Userspace transmitter, for systems without the kernel module: drives a
+// GPIO line through the character device (libgpiod v2 when built with it,
+// the raw uAPI otherwise) with the module line code. Frames are compiled
+// into an edge schedule first, then played by a dedicated SCHED_FIFO thread
+// (stack prefaulted) sleeping until each absolute edge time, so that a late
+// edge does not delay the next ones. Without the privileges for that the
+// thread keeps the normal scheduling (see IsRealTime()).
+//
+// bLockMemory calls mlockall(MCL_CURRENT | MCL_FUTURE): it locks the whole
+// host process (every later allocation and thread stack included) and is
+// never undone, so it is left to dedicated transmitter processes.
+//
+// Kernel framing is not available: frames come from CreateMessage(). Sends
+// from several threads are played one after the other (GetLastResult() and
+// GetJitter() then describe the last one).
+
+class CGPIOWireLine
+{
+public:
+  CGPIOWireLine(
+    const string&            sChip,       // e.g. "/dev/gpiochip0"
+    unsigned int             uiOffset,    // Line offset on the chip
+    const SGPIOWireLineCode& LineCode,
+    bool                     bSwapOutput = false,
+    int                      iPriority   = DEF_GPIO_LINE_PRIORITY,
+    unsigned long            ulSpinTime  = DEF_GPIO_LINE_SPIN_TIME,
+    bool                     bLockMemory = false
+  );
+
+  ~CGPIOWireLine();
+
+  CGPIOWireLine(const CGPIOWireLine&)            = delete;
+  CGPIOWireLine& operator=(const CGPIOWireLine&) = delete;
+
+  bool            IsOpen() const;
+  bool            IsRealTime() const;
+
+  // Result of the last operation (the constructor requests the line).
+
+  SGPIOWireResult GetLastResult() const;
+
+  // Same semantics as the session ones: blocking until transmitted.
+
+  SGPIOWireResult SendMessage(const unsigned char* lpMessage, size_t nSize);
+
+  SGPIOWireResult SendMessages(
+    const unsigned char* const* lpMessages,
+    const size_t*               lpSizes,
+    size_t                      nCount
+  );
+
+  SGPIOWireJitter GetJitter() const;
+
+  // Edge schedule of a burst, as played by the module timer: durations (uS)
+  // of the alternating line levels, low (lead in) first. lpFrameEnds gets
+  // the schedule index following each frame.
+
+  static void CreateSchedule(
+    const SGPIOWireLineCode&    LineCode,
+    const unsigned char* const* lpMessages,
+    const size_t*               lpSizes,
+    size_t                      nCount,
+    vector<uint32_t>&           lpSchedule,
+    vector<size_t>&             lpFrameEnds
+  );
+
+private:
+  SGPIOWireLineCode          m_LineCode;
+  unsigned int               m_uiOffset;
+  unsigned long              m_ulSpinTime;
+  bool                       m_bRealTime;
+  SGPIOWireResult            m_LastResult;
+
+#ifdef GPIOWIRE_LIBGPIOD
+  struct gpiod_line_request* m_lpRequest;
+#else
+  int                        m_iLine;
+#endif
+
+  // Schedule handed to the transmitter thread, one send at a time (held
+  // until its result is read)
+
+  mutex                      m_SendMutex;
+  mutable mutex              m_Mutex;
+  mutable condition_variable m_Signal;
+  bool                       m_bPending;
+  bool                       m_bStop;
+  vector<uint32_t>           m_lpSchedule;
+  vector<size_t>             m_lpFrameEnds;
+  vector<uint32_t>           m_lpLateness;
+  size_t                     m_nPlayed;  // Edges set before a failure
+  int                        m_iError;
+
+  thread                     m_Transmitter;
+
+  bool Open(const string& sChip, bool bSwapOutput);
+  void Close();
+  bool SetValue(bool bValue);
+  void Run();
+  void Play();
+  void Wait(uint64_t ulDeadline);
+
+  SGPIOWireResult SetResult(
+    int         iError,
+    const char* lpszOperation,
+    size_t      nFrames
+  );
+};
+
+#endif /* _GPIO_WIRE_LINE_HPP_ */
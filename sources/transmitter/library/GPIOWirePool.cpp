@@ -0,0 +1,273 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <assert.h>
+#include <dirent.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "GPIOWirePool.hpp"
+#include "Utils.hpp"
+
+#define GPIO_POOL_DEVICE_PREFIX "gpiowire"
+
+vector<unsigned short> CGPIOWirePool::Discover(const string& sSysClass)
+{
+  vector<unsigned short> lpDevices;
+  DIR*                   lpDir = opendir(sSysClass.c_str());
+
+  if (!lpDir)
+  {
+    return lpDevices;
+  }
+
+  struct dirent* lpEntry;
+  size_t         nPrefixLength = strlen(GPIO_POOL_DEVICE_PREFIX);
+
+  while (NULL != (lpEntry = readdir(lpDir)))
+  {
+    const char* lpszNumber = (lpEntry->d_name + nPrefixLength);
+    char*       lpszEnd    = NULL;
+
+    if (
+         strncmp(lpEntry->d_name, GPIO_POOL_DEVICE_PREFIX, nPrefixLength)
+      || !*lpszNumber
+    )
+    {
+      continue;
+    }
+
+    unsigned long ulNumber = strtoul(lpszNumber, &lpszEnd, 10);
+
+    if (!*lpszEnd && (ulNumber <= 0xFFFF))
+    {
+      lpDevices.push_back((unsigned short)ulNumber);
+    }
+  }
+
+  closedir(lpDir);
+
+  sort(lpDevices.begin(), lpDevices.end());
+
+  return lpDevices;
+}
+
+static vector<CGPIOWireSession> OpenSessions(
+  const vector<unsigned short>& lpDevices
+)
+{
+  vector<CGPIOWireSession> lpSessions;
+
+  for (size_t nIndex = 0; nIndex < lpDevices.size(); nIndex++)
+  {
+    lpSessions.push_back(CGPIOWireSession(
+      CUtils::FormatString("/dev/gpiowire%d", lpDevices[nIndex])
+    ));
+  }
+
+  return lpSessions;
+}
+
+CGPIOWirePool::CGPIOWirePool(
+  const vector<unsigned short>& lpDevices,
+  size_t                        nMaxDepth,
+  GPIOWirePoolPolicy            ePolicy
+)
+  : CGPIOWirePool(OpenSessions(lpDevices), nMaxDepth, ePolicy)
+{
+}
+
+CGPIOWirePool::CGPIOWirePool(
+  vector<CGPIOWireSession>&& lpSessions,
+  size_t                     nMaxDepth,
+  GPIOWirePoolPolicy         ePolicy
+)
+  : m_ePolicy(ePolicy)
+  , m_nNextDevice(0)
+  , m_ulStartTime(CUtils::GetMonotonicTime())
+{
+  for (size_t nIndex = 0; nIndex < lpSessions.size(); nIndex++)
+  {
+    unique_ptr<SDevice> lpDevice(new SDevice());
+
+    lpDevice->sDevice    = lpSessions[nIndex].GetDevice();
+    lpDevice->ulFrames   = 0;
+    lpDevice->ulBytes    = 0;
+    lpDevice->ulErrors   = 0;
+    lpDevice->ulRejected = 0;
+    lpDevice->ulLatency  = 0;
+    lpDevice->lpSender.reset(
+      new CGPIOWireSender(move(lpSessions[nIndex]), nMaxDepth)
+    );
+
+    m_lpDevices.push_back(move(lpDevice));
+  }
+}
+
+size_t CGPIOWirePool::GetDeviceCount() const
+{
+  return m_lpDevices.size();
+}
+
+void CGPIOWirePool::SetPolicy(GPIOWirePoolPolicy ePolicy)
+{
+  m_ePolicy = ePolicy;
+}
+
+void CGPIOWirePool::Pin(unsigned int uiKey, size_t nDevice)
+{
+  assert(nDevice < m_lpDevices.size());
+
+  lock_guard<mutex> Lock(m_PinsMutex);
+
+  m_lpPins[uiKey] = nDevice;
+}
+
+size_t CGPIOWirePool::SendMessage(
+  const unsigned char* lpMessage,
+  size_t               nSize,
+  unsigned int         uiKey
+)
+{
+  if (m_lpDevices.empty())
+  {
+    return 0;
+  }
+
+  if (GPIOWirePoolPolicy::Broadcast == m_ePolicy)
+  {
+    size_t nQueued = 0;
+
+    for (size_t nIndex = 0; nIndex < m_lpDevices.size(); nIndex++)
+    {
+      nQueued += (Enqueue(*m_lpDevices[nIndex], lpMessage, nSize) ? 1 : 0);
+    }
+
+    return nQueued;
+  }
+
+  SDevice& Device = *m_lpDevices[SelectDevice(uiKey)];
+
+  return (Enqueue(Device, lpMessage, nSize) ? 1 : 0);
+}
+
+vector<SGPIOWireDeviceStats> CGPIOWirePool::GetStatistics() const
+{
+  vector<SGPIOWireDeviceStats> lpStats;
+  double                       dElapsed = (
+    (CUtils::GetMonotonicTime() - m_ulStartTime) / 1000.0
+  );
+
+  if (dElapsed <= 0)
+  {
+    dElapsed = 0.001;
+  }
+
+  for (size_t nIndex = 0; nIndex < m_lpDevices.size(); nIndex++)
+  {
+    const SDevice&       Device = *m_lpDevices[nIndex];
+    SGPIOWireDeviceStats Stats;
+
+    Stats.sDevice       = Device.sDevice;
+    Stats.nDepth        = Device.lpSender->GetDepth();
+    Stats.ulFrames      = Device.ulFrames;
+    Stats.ulBytes       = Device.ulBytes;
+    Stats.ulErrors      = Device.ulErrors;
+    Stats.ulRejected    = Device.ulRejected;
+    Stats.ulLatency     = Device.ulLatency;
+    Stats.dFramesPerSec = (Stats.ulFrames / dElapsed);
+    Stats.dBytesPerSec  = (Stats.ulBytes  / dElapsed);
+
+    lpStats.push_back(Stats);
+  }
+
+  return lpStats;
+}
+
+size_t CGPIOWirePool::SelectDevice(unsigned int uiKey)
+{
+  if (GPIOWirePoolPolicy::Pinned == m_ePolicy)
+  {
+    lock_guard<mutex> Lock(m_PinsMutex);
+
+    map<unsigned int, size_t>::const_iterator Pin = m_lpPins.find(uiKey);
+
+    return (
+        (m_lpPins.end() != Pin)
+      ? Pin->second
+      : (uiKey % m_lpDevices.size())
+    );
+  }
+
+  // Least queued, scanning from a rotating start to spread ties
+
+  size_t nCount = m_lpDevices.size();
+  size_t nStart = (m_nNextDevice.fetch_add(1) % nCount);
+  size_t nBest  = nStart;
+  size_t nDepth = m_lpDevices[nStart]->lpSender->GetDepth();
+
+  for (size_t nOffset = 1; (nOffset < nCount) && (nDepth > 0); nOffset++)
+  {
+    size_t nIndex = ((nStart + nOffset) % nCount);
+    size_t nOther = m_lpDevices[nIndex]->lpSender->GetDepth();
+
+    if (nOther < nDepth)
+    {
+      nBest  = nIndex;
+      nDepth = nOther;
+    }
+  }
+
+  return nBest;
+}
+
+bool CGPIOWirePool::Enqueue(
+  SDevice&             Device,
+  const unsigned char* lpMessage,
+  size_t               nSize
+)
+{
+  SDevice* lpDevice = &Device;
+
+  return Device.lpSender->SendMessage(
+    lpMessage,
+    nSize,
+    [lpDevice, nSize](const SGPIOWireSendReport& Report)
+    {
+      if (Report.Result)
+      {
+        lpDevice->ulFrames++;
+        lpDevice->ulBytes   += nSize;
+        lpDevice->ulLatency += Report.ulLatency;
+      }
+      else if (EAGAIN == Report.Result.iError)
+      {
+        lpDevice->ulRejected++;
+      }
+      else
+      {
+        lpDevice->ulErrors++;
+      }
+    }
+  );
+}
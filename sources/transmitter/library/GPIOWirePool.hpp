@@ -0,0 +1,139 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef _GPIO_WIRE_POOL_HPP_
+#define _GPIO_WIRE_POOL_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <GPIOWireSender.hpp>
+#include <GPIOWireSession.hpp>
+
+using namespace std;
+
+#define DEF_GPIO_POOL_SYS_CLASS "/sys/class/gpiowires"
+
+enum class GPIOWirePoolPolicy
+{
+  LeastQueued = 0, // Device with the shortest queue
+  Pinned      = 1, // Same device for the same destination key
+  Broadcast   = 2  // Every device
+};
+
+struct SGPIOWireDeviceStats
+{
+  string   sDevice;
+  size_t   nDepth;         // Frames queued now
+  uint64_t ulFrames;       // Frames sent
+  uint64_t ulBytes;        // Bytes sent
+  uint64_t ulErrors;       // Frames failed while sending
+  uint64_t ulRejected;     // Frames rejected by a full queue
+  uint64_t ulLatency;      // Total send latency (uS)
+  double   dFramesPerSec;  // Since the pool creation
+  double   dBytesPerSec;
+};
+
+// Fans frames out on many devices at once, each one with its own
+// asynchronous sender (queue and writer thread).
+
+class CGPIOWirePool
+{
+public:
+  // Device numbers of "/sys/class/gpiowires/gpiowireN" entries (sorted).
+
+  static vector<unsigned short> Discover(
+    const string& sSysClass = DEF_GPIO_POOL_SYS_CLASS
+  );
+
+  CGPIOWirePool(
+    const vector<unsigned short>& lpDevices,
+    size_t                        nMaxDepth,
+    GPIOWirePoolPolicy            ePolicy = GPIOWirePoolPolicy::LeastQueued
+  );
+
+  CGPIOWirePool(
+    vector<CGPIOWireSession>&& lpSessions,
+    size_t                     nMaxDepth,
+    GPIOWirePoolPolicy         ePolicy = GPIOWirePoolPolicy::LeastQueued
+  );
+
+  CGPIOWirePool(const CGPIOWirePool&)            = delete;
+  CGPIOWirePool& operator=(const CGPIOWirePool&) = delete;
+
+  size_t GetDeviceCount() const;
+
+  void   SetPolicy(GPIOWirePoolPolicy ePolicy);
+
+  // Pinned policy: uiKey (e.g. destination address) is sent by nDevice,
+  // unpinned keys by device uiKey % GetDeviceCount().
+
+  void   Pin(unsigned int uiKey, size_t nDevice);
+
+  // Returns the number of devices the frame has been queued on (0 when
+  // their queues are full).
+
+  size_t SendMessage(
+    const unsigned char* lpMessage,
+    size_t               nSize,
+    unsigned int         uiKey = 0
+  );
+
+  vector<SGPIOWireDeviceStats> GetStatistics() const;
+
+private:
+  struct SDevice
+  {
+    string                      sDevice;
+    atomic<uint64_t>            ulFrames;
+    atomic<uint64_t>            ulBytes;
+    atomic<uint64_t>            ulErrors;
+    atomic<uint64_t>            ulRejected;
+    atomic<uint64_t>            ulLatency;
+
+    // Last, so destroyed first: its writer thread drains the pending frames
+    // into the counters above
+
+    unique_ptr<CGPIOWireSender> lpSender;
+  };
+
+  vector<unique_ptr<SDevice>> m_lpDevices;
+  atomic<GPIOWirePoolPolicy>  m_ePolicy;
+  atomic<size_t>              m_nNextDevice;
+  mutable mutex               m_PinsMutex;
+  map<unsigned int, size_t>   m_lpPins;
+  uint64_t                    m_ulStartTime;
+
+  size_t SelectDevice(unsigned int uiKey);
+  bool   Enqueue(
+    SDevice&             Device,
+    const unsigned char* lpMessage,
+    size_t               nSize
+  );
+};
+
+#endif /* _GPIO_WIRE_POOL_HPP_ */
@@ -0,0 +1,106 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef _GPIO_WIRE_PROTOCOL_HPP_
+#define _GPIO_WIRE_PROTOCOL_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+using namespace std;
+
+// gpiowired protocol: SOCK_SEQPACKET Unix socket, one request (header plus
+// frame) per packet, one reply per request. The shared memory fast path is
+// a single producer (client), single consumer (daemon) byte ring, handed to
+// the daemon (sealed memfd) by an attach request. The daemon replies with
+// the doorbell and completion eventfds, created by itself so that it never
+// blocks on them.
+
+#define DEF_GPIOWIRED_SOCKET      "/run/gpiowired.sock"
+#define DEF_GPIOWIRED_PRIORITIES  4       // 0 (lowest) to 3 (highest)
+#define DEF_GPIOWIRED_MAX_FRAME   2048
+#define DEF_GPIOWIRED_RING_SIZE   65536
+#define DEF_GPIOWIRED_RING_MAGIC  0x52575047 // "GPWR"
+
+enum GPIOWireRequestType : uint8_t
+{
+  GPIOWIRE_REQUEST_SEND       = 1, // Frame follows, replied once sent
+  GPIOWIRE_REQUEST_ATTACH     = 2, // Ring fd, replied with the eventfds
+  GPIOWIRE_REQUEST_STATISTICS = 3  // Replied with text
+};
+
+struct SGPIOWireRequest
+{
+  uint8_t  uiType;
+  uint8_t  uiPriority;
+  uint16_t uiDevice;
+  uint32_t uiSequence;
+};
+
+struct SGPIOWireReply
+{
+  uint32_t uiSequence;
+  int32_t  iError;
+};
+
+// Ring records are 8 bytes aligned and never wrap: a skip record fills the
+// ring end when the next record does not fit.
+
+#define GPIOWIRE_RING_ALIGN  8
+#define GPIOWIRE_RING_SKIP   0xFFFFFFFF
+
+struct SGPIOWireRingRecord
+{
+  uint16_t uiDevice;
+  uint8_t  uiPriority;
+  uint8_t  uiReserved;
+  uint32_t uiSize;     // Frame bytes following, or GPIOWIRE_RING_SKIP
+};
+
+struct SGPIOWireRing
+{
+  uint32_t                     uiMagic;
+  uint32_t                     uiSize;      // Data bytes (power of two)
+
+  alignas(64) atomic<uint64_t> ulHead;      // Bytes written (client)
+  alignas(64) atomic<uint32_t> uiWaiting;   // Daemon idle: ring the doorbell
+  alignas(64) atomic<uint64_t> ulTail;      // Bytes read (daemon)
+  alignas(64) atomic<uint64_t> ulCompleted; // Frames done (daemon)
+  atomic<uint64_t>             ulFailed;    // Frames failed (daemon)
+};
+
+// Data follow the header
+
+inline unsigned char* GetRingData(SGPIOWireRing* lpRing)
+{
+  return ((unsigned char *)lpRing + sizeof(SGPIOWireRing));
+}
+
+inline size_t GetRingRecordSize(size_t nSize)
+{
+  return (
+      (sizeof(SGPIOWireRingRecord) + nSize + (GPIOWIRE_RING_ALIGN - 1))
+    & ~(size_t)(GPIOWIRE_RING_ALIGN - 1)
+  );
+}
+
+#endif /* _GPIO_WIRE_PROTOCOL_HPP_ */
@@ -0,0 +1,418 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <assert.h>
+#include <errno.h>
+#include <time.h>
+
+#include "GPIOWireScheduler.hpp"
+
+/***************************/
+/* SGPIOWireSchedulerStats */
+/***************************/
+
+double SGPIOWireSchedulerStats::GetMissRatio() const
+{
+  return (
+      nDeadlines
+    ? ((double)(nDropped + nLate) / nDeadlines)
+    : 0.0
+  );
+}
+
+/**********************/
+/* CGPIOWireScheduler */
+/**********************/
+
+bool CGPIOWireScheduler::SOrder::operator<(const SOrder& Order) const
+{
+  if (ulDeadline != Order.ulDeadline)
+  {
+    return (ulDeadline < Order.ulDeadline);
+  }
+
+  if (uiPriority != Order.uiPriority)
+  {
+    return (uiPriority > Order.uiPriority);
+  }
+
+  return (ulSequence < Order.ulSequence);
+}
+
+CGPIOWireScheduler::CGPIOWireScheduler(
+  CGPIOWire&         GPIOWire,
+  CGPIOWireSession&& Session,
+  size_t             nMaxDepth,
+  bool               bDropMissed
+)
+  : m_GPIOWire(GPIOWire)
+  , m_Session(move(Session))
+  , m_nMaxDepth(nMaxDepth)
+  , m_bDropMissed(bDropMissed)
+  , m_lpDutyCycle(NULL)
+  , m_ulSequence(0)
+  , m_bStop(false)
+  , m_Stats({ 0, 0, 0, 0, 0, 0, 0, 0, 0 })
+{
+  assert(nMaxDepth > 0);
+
+  m_Dispatcher = thread(&CGPIOWireScheduler::Run, this);
+}
+
+CGPIOWireScheduler::~CGPIOWireScheduler()
+{
+  {
+    lock_guard<mutex> Lock(m_Mutex);
+
+    m_bStop = true;
+  }
+
+  m_Signal.notify_one();
+  m_Dispatcher.join();
+}
+
+bool CGPIOWireScheduler::SendMessage(
+  const unsigned char*     lpMessage,
+  size_t                   nSize,
+  uint64_t                 ulDeadline,
+  unsigned int             uiPriority,
+  GPIOWireScheduleCallback lpfnCallback
+)
+{
+  SFrame Frame;
+
+  Frame.bKeyed = false;
+  Frame.uiKey  = 0;
+
+  return Submit(
+    Frame,
+    lpMessage,
+    nSize,
+    ulDeadline,
+    uiPriority,
+    move(lpfnCallback)
+  );
+}
+
+bool CGPIOWireScheduler::SendLatest(
+  uint32_t                 uiKey,
+  const unsigned char*     lpMessage,
+  size_t                   nSize,
+  uint64_t                 ulDeadline,
+  unsigned int             uiPriority,
+  GPIOWireScheduleCallback lpfnCallback
+)
+{
+  SFrame Frame;
+
+  Frame.bKeyed = true;
+  Frame.uiKey  = uiKey;
+
+  return Submit(
+    Frame,
+    lpMessage,
+    nSize,
+    ulDeadline,
+    uiPriority,
+    move(lpfnCallback)
+  );
+}
+
+size_t CGPIOWireScheduler::GetDepth() const
+{
+  lock_guard<mutex> Lock(m_Mutex);
+
+  return m_Frames.size();
+}
+
+SGPIOWireSchedulerStats CGPIOWireScheduler::GetStatistics() const
+{
+  lock_guard<mutex> Lock(m_Mutex);
+
+  return m_Stats;
+}
+
+void CGPIOWireScheduler::SetDutyCycle(CGPIOWireDutyCycle* lpDutyCycle)
+{
+  lock_guard<mutex> Lock(m_Mutex);
+
+  m_lpDutyCycle = lpDutyCycle;
+}
+
+uint64_t CGPIOWireScheduler::GetTime()
+{
+  struct timespec Time;
+
+  clock_gettime(CLOCK_MONOTONIC, &Time);
+
+  return ((uint64_t)Time.tv_sec * 1000000) + (Time.tv_nsec / 1000);
+}
+
+bool CGPIOWireScheduler::Submit(
+  SFrame&                  Frame,
+  const unsigned char*     lpMessage,
+  size_t                   nSize,
+  uint64_t                 ulDeadline,
+  unsigned int             uiPriority,
+  GPIOWireScheduleCallback lpfnCallback
+)
+{
+  Frame.lpMessage.assign(lpMessage, (lpMessage + nSize));
+  Frame.ulAirTime    = m_GPIOWire.GetAirTime(lpMessage, nSize);
+  Frame.ulOnAirTime  = m_GPIOWire.GetOnAirTime(lpMessage, nSize);
+  Frame.ulSubmitTime = GetTime();
+
+  SOrder Order = {
+    (ulDeadline ? (Frame.ulSubmitTime + ulDeadline) : UINT64_MAX),
+    uiPriority,
+    0
+  };
+
+  SFrame Superseded;
+  bool   bSuperseded = false;
+  bool   bQueued     = false;
+
+  {
+    lock_guard<mutex> Lock(m_Mutex);
+
+    auto lpKey = (Frame.bKeyed ? m_Keys.find(Frame.uiKey) : m_Keys.end());
+
+    if (m_Keys.end() != lpKey)
+    {
+      // The new frame takes the place of the superseded one, so the queue
+      // depth does not change
+
+      auto lpEntry = m_Frames.find(lpKey->second);
+
+      assert(m_Frames.end() != lpEntry);
+
+      Superseded  = move(lpEntry->second);
+      bSuperseded = true;
+
+      m_Frames.erase(lpEntry);
+      m_Stats.nCoalesced++;
+    }
+
+    if (bSuperseded || (m_Frames.size() < m_nMaxDepth))
+    {
+      Order.ulSequence   = m_ulSequence++;
+      Frame.lpfnCallback = move(lpfnCallback);
+
+      if (Frame.bKeyed)
+      {
+        m_Keys[Frame.uiKey] = Order;
+      }
+
+      m_Frames.emplace(Order, move(Frame));
+      m_Stats.nSubmitted++;
+
+      m_Signal.notify_one();
+
+      bQueued = true;
+    }
+  }
+
+  if (!bQueued)
+  {
+    if (lpfnCallback)
+    {
+      lpfnCallback({ { EAGAIN, "enqueue", 0 }, 0, false });
+    }
+
+    return false;
+  }
+
+  if (bSuperseded && Superseded.lpfnCallback)
+  {
+    Superseded.lpfnCallback(
+      {
+        { ECANCELED, "coalesce", 0 },
+        (GetTime() - Superseded.ulSubmitTime),
+        false
+      }
+    );
+  }
+
+  return true;
+}
+
+void CGPIOWireScheduler::Run()
+{
+  unique_lock<mutex> Lock(m_Mutex);
+
+  for (;;)
+  {
+    m_Signal.wait(Lock, [this]() { return (m_bStop || !m_Frames.empty()); });
+
+    if (m_Frames.empty())
+    {
+      break;
+    }
+
+    // Earliest deadline first
+
+    auto     lpEntry   = m_Frames.begin();
+    uint64_t ulNow     = GetTime();
+    uint64_t ulEnd     = (ulNow + lpEntry->second.ulAirTime);
+    uint64_t ulDelay   = 0;
+    bool     bDeadline = (UINT64_MAX != lpEntry->first.ulDeadline);
+    bool     bFeasible = (
+         !bDeadline
+      || !m_bDropMissed
+      || (ulEnd <= lpEntry->first.ulDeadline)
+    );
+
+    if (bFeasible && m_lpDutyCycle)
+    {
+      // Admitting may save the duty cycle state file: not under the lock, so
+      // that submitters never wait for the disk
+
+      CGPIOWireDutyCycle* lpDutyCycle = m_lpDutyCycle;
+      SOrder              Admitted    = lpEntry->first;
+      unsigned long       ulOnAirTime = lpEntry->second.ulOnAirTime;
+
+      Lock.unlock();
+
+      ulDelay = lpDutyCycle->Admit(ulOnAirTime);
+
+      Lock.lock();
+
+      // Coalesced meanwhile: its air time stays spent (never under counted)
+      // and the replacement is admitted on its own
+
+      lpEntry = m_Frames.find(Admitted);
+
+      if (m_Frames.end() == lpEntry)
+      {
+        continue;
+      }
+
+      if ((0 != ulDelay) && (UINT64_MAX != ulDelay) && !m_bStop)
+      {
+        if (
+             !bDeadline
+          || !m_bDropMissed
+          || ((ulEnd + ulDelay) <= lpEntry->first.ulDeadline)
+        )
+        {
+          // Wait for the budget, or for a more urgent frame
+
+          m_Signal.wait_for(Lock, chrono::microseconds(ulDelay));
+          continue;
+        }
+
+        bFeasible = false;
+      }
+    }
+
+    SOrder Order = lpEntry->first;
+    SFrame Frame = move(lpEntry->second);
+
+    m_Frames.erase(lpEntry);
+
+    if (Frame.bKeyed)
+    {
+      m_Keys.erase(Frame.uiKey);
+    }
+
+    SGPIOWireScheduleReport Report = { { 0, NULL, 0 }, 0, false };
+
+    if (!bFeasible)
+    {
+      m_Stats.nDeadlines++;
+      m_Stats.nDropped++;
+
+      Report.Result    = { ETIMEDOUT, "schedule", 0 };
+      Report.ulLatency = (ulNow - Frame.ulSubmitTime);
+      Report.bMissed   = true;
+    }
+    else if (0 != ulDelay)
+    {
+      // Never fits the duty cycle budget, or stopping
+
+      m_Stats.nRejected++;
+
+      Report.Result    = {
+        ((UINT64_MAX == ulDelay) ? EMSGSIZE : EBUSY),
+        "duty cycle",
+        0
+      };
+      Report.ulLatency = (ulNow - Frame.ulSubmitTime);
+    }
+    else
+    {
+      Lock.unlock();
+
+      if (!m_Session.IsOpen())
+      {
+        m_Session.Reconnect();
+      }
+
+      Report.Result = m_Session.SendMessage(
+        Frame.lpMessage.data(),
+        Frame.lpMessage.size()
+      );
+
+      // Reopen the device on next frame after a failure
+
+      if (!Report.Result && (EINTR != Report.Result.iError))
+      {
+        m_Session.Close();
+      }
+
+      ulNow            = GetTime();
+      Report.ulLatency = (ulNow - Frame.ulSubmitTime);
+      Report.bMissed   = (bDeadline && (ulNow > Order.ulDeadline));
+
+      Lock.lock();
+
+      if (Report.Result)
+      {
+        m_Stats.nSent++;
+      }
+      else
+      {
+        m_Stats.nFailed++;
+      }
+
+      if (bDeadline)
+      {
+        m_Stats.nDeadlines++;
+      }
+
+      if (Report.bMissed)
+      {
+        m_Stats.nLate++;
+
+        if ((ulNow - Order.ulDeadline) > m_Stats.ulMaxLateness)
+        {
+          m_Stats.ulMaxLateness = (ulNow - Order.ulDeadline);
+        }
+      }
+    }
+
+    if (Frame.lpfnCallback)
+    {
+      Lock.unlock();
+      Frame.lpfnCallback(Report);
+      Lock.lock();
+    }
+  }
+}
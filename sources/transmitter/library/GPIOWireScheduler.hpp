@@ -0,0 +1,175 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef _GPIO_WIRE_SCHEDULER_HPP_
+#define _GPIO_WIRE_SCHEDULER_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <GPIOWire.hpp>
+#include <GPIOWireDutyCycle.hpp>
+#include <GPIOWireSession.hpp>
+
+using namespace std;
+
+struct SGPIOWireScheduleReport
+{
+  SGPIOWireResult Result;    // ETIMEDOUT when dropped, EAGAIN when full,
+                             // ECANCELED when superseded, EMSGSIZE or
+                             // EBUSY (stopping) when over the duty cycle
+  uint64_t        ulLatency; // uS, from submission to transmission end
+  bool            bMissed;   // Deadline missed (dropped or sent late)
+};
+
+typedef function<void(const SGPIOWireScheduleReport&)> GPIOWireScheduleCallback;
+
+struct SGPIOWireSchedulerStats
+{
+  size_t   nSubmitted;
+  size_t   nSent;
+  size_t   nFailed;       // Write errors
+  size_t   nDeadlines;    // Frames with a deadline, done with
+  size_t   nDropped;      // Could not meet their deadline any more
+  size_t   nLate;         // Sent, but ended after their deadline
+  size_t   nCoalesced;    // Replaced by a newer frame with the same key
+  size_t   nRejected;     // Over the duty cycle budget
+  uint64_t ulMaxLateness; // uS
+
+  double GetMissRatio() const;
+};
+
+// Earliest deadline first scheduler: frames are sent one at a time by a
+// dispatcher thread, the one with the nearest deadline first (then the
+// highest priority, then in submission order): frames without a deadline go
+// last, by priority. The air time of each frame is estimated on submission by
+// CGPIOWire::GetAirTime(), so a frame which would end after its deadline is
+// dropped (or sent anyway and reported as missed, when bDropMissed is
+// false). Pending frames are still processed by the destructor.
+
+class CGPIOWireScheduler
+{
+public:
+  CGPIOWireScheduler(
+    CGPIOWire&         GPIOWire,
+    CGPIOWireSession&& Session,
+    size_t             nMaxDepth,
+    bool               bDropMissed = true
+  );
+
+  ~CGPIOWireScheduler();
+
+  CGPIOWireScheduler(const CGPIOWireScheduler&)            = delete;
+  CGPIOWireScheduler& operator=(const CGPIOWireScheduler&) = delete;
+
+  // ulDeadline is relative (uS, 0 = none), the frame is copied. The callback
+  // runs on the dispatcher thread (or at once, with EAGAIN, when the queue
+  // is full: false is returned then).
+
+  bool SendMessage(
+    const unsigned char*     lpMessage,
+    size_t                   nSize,
+    uint64_t                 ulDeadline,
+    unsigned int             uiPriority  = 0,
+    GPIOWireScheduleCallback lpfnCallback = NULL
+  );
+
+  // Latest value submission: the frame replaces the queued (not yet sent)
+  // one with the same key, if any, so that air time is spent on the newest
+  // state only and the queue is bounded by the number of keys. The replaced
+  // frame is reported with ECANCELED.
+
+  bool SendLatest(
+    uint32_t                 uiKey,
+    const unsigned char*     lpMessage,
+    size_t                   nSize,
+    uint64_t                 ulDeadline,
+    unsigned int             uiPriority  = 0,
+    GPIOWireScheduleCallback lpfnCallback = NULL
+  );
+
+  // Frames wait for the duty cycle budget (not owned, NULL = none), their
+  // deadlines accounting for the wait. Pending frames which do not fit the
+  // budget at destruction time are rejected.
+
+  void SetDutyCycle(CGPIOWireDutyCycle* lpDutyCycle);
+
+  size_t                  GetDepth() const;
+  SGPIOWireSchedulerStats GetStatistics() const;
+
+  static uint64_t GetTime();
+
+private:
+  struct SOrder
+  {
+    uint64_t     ulDeadline; // Absolute, UINT64_MAX = none
+    unsigned int uiPriority;
+    uint64_t     ulSequence;
+
+    bool operator<(const SOrder& Order) const;
+  };
+
+  struct SFrame
+  {
+    vector<unsigned char>    lpMessage;
+    unsigned long            ulAirTime;   // Repeat gaps included
+    unsigned long            ulOnAirTime; // Charged to the duty cycle
+    uint64_t                 ulSubmitTime;
+    GPIOWireScheduleCallback lpfnCallback;
+    bool                     bKeyed;
+    uint32_t                 uiKey;
+  };
+
+  CGPIOWire&              m_GPIOWire;
+  CGPIOWireSession        m_Session;
+  size_t                  m_nMaxDepth;
+  bool                    m_bDropMissed;
+  CGPIOWireDutyCycle*     m_lpDutyCycle;
+
+  mutable mutex           m_Mutex;
+  condition_variable      m_Signal;
+  map<SOrder, SFrame>     m_Frames;
+  map<uint32_t, SOrder>   m_Keys;    // Queued keyed frames
+  uint64_t                m_ulSequence;
+  bool                    m_bStop;
+  SGPIOWireSchedulerStats m_Stats;
+
+  thread                  m_Dispatcher;
+
+  bool Submit(
+    SFrame&                  Frame,
+    const unsigned char*     lpMessage,
+    size_t                   nSize,
+    uint64_t                 ulDeadline,
+    unsigned int             uiPriority,
+    GPIOWireScheduleCallback lpfnCallback
+  );
+
+  void Run();
+};
+
+#endif /* _GPIO_WIRE_SCHEDULER_HPP_ */
@@ -0,0 +1,294 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <assert.h>
+#include <errno.h>
+#include <time.h>
+
+#include "GPIOWireSender.hpp"
+
+CGPIOWireSender::CGPIOWireSender(
+  CGPIOWireSession&& Session,
+  size_t             nMaxDepth
+)
+  : m_Session(move(Session))
+  , m_nMaxDepth(nMaxDepth)
+  , m_nDepth(0)
+  , m_bStop(false)
+  , m_uiSignal(0)
+  , m_lpHead(&m_Stub)
+  , m_lpTail(&m_Stub)
+{
+  assert(nMaxDepth > 0);
+
+  m_Stub.lpNext.store(NULL, memory_order_relaxed);
+
+  m_Writer = thread(&CGPIOWireSender::Run, this);
+}
+
+CGPIOWireSender::~CGPIOWireSender()
+{
+  m_bStop.store(true, memory_order_release);
+
+  m_uiSignal.fetch_add(1, memory_order_release);
+  m_uiSignal.notify_one();
+
+  m_Writer.join();
+}
+
+future<SGPIOWireSendReport> CGPIOWireSender::SendMessage(
+  const unsigned char* lpMessage,
+  size_t               nSize
+)
+{
+  SNode* lpNode = new SNode();
+
+  lpNode->lpMessage.assign(lpMessage, (lpMessage + nSize));
+
+  future<SGPIOWireSendReport> Future = lpNode->Promise.get_future();
+
+  if (!Enqueue(lpNode))
+  {
+    lpNode->Promise.set_value({ { EAGAIN, "enqueue", 0 }, 0 });
+    delete lpNode;
+  }
+
+  return Future;
+}
+
+bool CGPIOWireSender::SendMessage(
+  const unsigned char* lpMessage,
+  size_t               nSize,
+  GPIOWireSendCallback lpfnCallback
+)
+{
+  SNode* lpNode = new SNode();
+
+  lpNode->lpMessage.assign(lpMessage, (lpMessage + nSize));
+  lpNode->lpfnCallback = move(lpfnCallback);
+
+  if (!Enqueue(lpNode))
+  {
+    if (lpNode->lpfnCallback)
+    {
+      lpNode->lpfnCallback({ { EAGAIN, "enqueue", 0 }, 0 });
+    }
+
+    delete lpNode;
+
+    return false;
+  }
+
+  return true;
+}
+
+size_t CGPIOWireSender::GetDepth() const
+{
+  return m_nDepth.load(memory_order_relaxed);
+}
+
+bool CGPIOWireSender::Enqueue(SNode* lpNode)
+{
+  if (m_nDepth.fetch_add(1, memory_order_relaxed) >= m_nMaxDepth)
+  {
+    m_nDepth.fetch_sub(1, memory_order_relaxed);
+
+    return false;
+  }
+
+  lpNode->ulEnqueueTime = GetTime();
+
+  Push(lpNode);
+
+  m_uiSignal.fetch_add(1, memory_order_release);
+  m_uiSignal.notify_one();
+
+  return true;
+}
+
+void CGPIOWireSender::Push(SNode* lpNode)
+{
+  lpNode->lpNext.store(NULL, memory_order_relaxed);
+
+  SNode* lpPrevious = m_lpHead.exchange(lpNode, memory_order_acq_rel);
+
+  lpPrevious->lpNext.store(lpNode, memory_order_release);
+}
+
+CGPIOWireSender::SNode* CGPIOWireSender::Pop()
+{
+  SNode* lpTail = m_lpTail;
+  SNode* lpNext = lpTail->lpNext.load(memory_order_acquire);
+
+  if (&m_Stub == lpTail)
+  {
+    if (!lpNext)
+    {
+      return NULL;
+    }
+
+    m_lpTail = lpNext;
+    lpTail   = lpNext;
+    lpNext   = lpNext->lpNext.load(memory_order_acquire);
+  }
+
+  if (lpNext)
+  {
+    m_lpTail = lpNext;
+
+    return lpTail;
+  }
+
+  if (lpTail != m_lpHead.load(memory_order_acquire))
+  {
+    // A producer is linking a node: retry later
+
+    return NULL;
+  }
+
+  // Last node: put the stub back behind it, so that it can be detached
+
+  Push(&m_Stub);
+
+  lpNext = lpTail->lpNext.load(memory_order_acquire);
+
+  if (lpNext)
+  {
+    m_lpTail = lpNext;
+
+    return lpTail;
+  }
+
+  return NULL;
+}
+
+void CGPIOWireSender::Complete(SNode* lpNode, const SGPIOWireResult& Result)
+{
+  SGPIOWireSendReport Report = {
+    Result,
+    (GetTime() - lpNode->ulEnqueueTime)
+  };
+
+  // Release the slot first: a completion may enqueue the next frame at once
+
+  m_nDepth.fetch_sub(1, memory_order_relaxed);
+
+  if (lpNode->lpfnCallback)
+  {
+    lpNode->lpfnCallback(Report);
+  }
+  else
+  {
+    lpNode->Promise.set_value(Report);
+  }
+
+  delete lpNode;
+}
+
+void CGPIOWireSender::Run()
+{
+  vector<SNode*>               lpNodes;
+  vector<const unsigned char*> lpMessages;
+  vector<size_t>               lpSizes;
+
+  lpNodes.reserve(DEF_GPIO_SENDER_MAX_BURST);
+  lpMessages.reserve(DEF_GPIO_SENDER_MAX_BURST);
+  lpSizes.reserve(DEF_GPIO_SENDER_MAX_BURST);
+
+  for (;;)
+  {
+    // Read the signal before checking the queue, so no wake up is lost
+
+    uint32_t uiSignal = m_uiSignal.load(memory_order_acquire);
+    SNode*   lpNode;
+
+    while (
+         (lpNodes.size() < DEF_GPIO_SENDER_MAX_BURST)
+      && (NULL != (lpNode = Pop()))
+    )
+    {
+      lpNodes.push_back(lpNode);
+      lpMessages.push_back(lpNode->lpMessage.data());
+      lpSizes.push_back(lpNode->lpMessage.size());
+    }
+
+    if (lpNodes.empty())
+    {
+      if (m_bStop.load(memory_order_acquire) && !m_nDepth.load())
+      {
+        break;
+      }
+
+      m_uiSignal.wait(uiSignal, memory_order_acquire);
+      continue;
+    }
+
+    if (!m_Session.IsOpen())
+    {
+      m_Session.Reconnect();
+    }
+
+    SGPIOWireResult Result = m_Session.SendMessages(
+      lpMessages.data(),
+      lpSizes.data(),
+      lpNodes.size()
+    );
+
+    for (size_t nIndex = 0; nIndex < lpNodes.size(); nIndex++)
+    {
+      SGPIOWireResult FrameResult = Result;
+
+      FrameResult.nFrames = ((nIndex < Result.nFrames) ? 1 : 0);
+
+      if (nIndex < Result.nFrames)
+      {
+        FrameResult.iError        = 0;
+        FrameResult.lpszOperation = NULL;
+      }
+      else if (!FrameResult.iError)
+      {
+        FrameResult.iError        = EINTR;
+        FrameResult.lpszOperation = "writev";
+      }
+
+      Complete(lpNodes[nIndex], FrameResult);
+    }
+
+    // Reopen the device on next burst after a failure
+
+    if (!Result && (EINTR != Result.iError))
+    {
+      m_Session.Close();
+    }
+
+    lpNodes.clear();
+    lpMessages.clear();
+    lpSizes.clear();
+  }
+}
+
+uint64_t CGPIOWireSender::GetTime()
+{
+  struct timespec Time;
+
+  clock_gettime(CLOCK_MONOTONIC, &Time);
+
+  return ((uint64_t)Time.tv_sec * 1000000) + (Time.tv_nsec / 1000);
+}
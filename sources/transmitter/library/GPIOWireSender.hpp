@@ -0,0 +1,114 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef _GPIO_WIRE_SENDER_HPP_
+#define _GPIO_WIRE_SENDER_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include <GPIOWireSession.hpp>
+
+using namespace std;
+
+#define DEF_GPIO_SENDER_MAX_BURST 64 // Frames chained by a single writev()
+
+struct SGPIOWireSendReport
+{
+  SGPIOWireResult Result;    // EAGAIN when the queue is full
+  uint64_t        ulLatency; // uS, from enqueue to transmission end
+};
+
+typedef function<void(const SGPIOWireSendReport&)> GPIOWireSendCallback;
+
+// Asynchronous sender: any thread enqueues frames (lock free, never
+// blocking on air time) into a queue drained by a dedicated writer thread,
+// which chains all the pending frames into a single vectored write so the
+// device stays busy back to back. Pending frames are still sent by the
+// destructor.
+
+class CGPIOWireSender
+{
+public:
+  CGPIOWireSender(CGPIOWireSession&& Session, size_t nMaxDepth);
+  ~CGPIOWireSender();
+
+  CGPIOWireSender(const CGPIOWireSender&)            = delete;
+  CGPIOWireSender& operator=(const CGPIOWireSender&) = delete;
+
+  // The frame is copied, so the caller buffer can be reused at once.
+
+  future<SGPIOWireSendReport> SendMessage(
+    const unsigned char* lpMessage,
+    size_t               nSize
+  );
+
+  // The callback runs on the writer thread (or at once, with EAGAIN, when
+  // the queue is full: false is returned then).
+
+  bool SendMessage(
+    const unsigned char* lpMessage,
+    size_t               nSize,
+    GPIOWireSendCallback lpfnCallback
+  );
+
+  size_t GetDepth() const;
+
+private:
+  struct SNode
+  {
+    atomic<SNode*>               lpNext;
+    vector<unsigned char>        lpMessage;
+    uint64_t                     ulEnqueueTime;
+    promise<SGPIOWireSendReport> Promise;
+    GPIOWireSendCallback         lpfnCallback;
+  };
+
+  CGPIOWireSession m_Session;
+  size_t           m_nMaxDepth;
+  atomic<size_t>   m_nDepth;
+  atomic<bool>     m_bStop;
+  atomic<uint32_t> m_uiSignal;
+
+  // Intrusive MPSC queue (D. Vyukov): producers exchange the head, the
+  // writer thread owns the tail.
+
+  SNode            m_Stub;
+  atomic<SNode*>   m_lpHead;
+  SNode*           m_lpTail;
+
+  thread           m_Writer;
+
+  bool   Enqueue(SNode* lpNode);
+  void   Push(SNode* lpNode);
+  SNode* Pop();
+  void   Complete(SNode* lpNode, const SGPIOWireResult& Result);
+  void   Run();
+
+  static uint64_t GetTime();
+};
+
+#endif /* _GPIO_WIRE_SENDER_HPP_ */
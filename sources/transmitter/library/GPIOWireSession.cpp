@@ -0,0 +1,230 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "GPIOWireSession.hpp"
+#include "Utils.hpp"
+
+string SGPIOWireResult::GetDescription() const
+{
+  if (!iError)
+  {
+    return "success";
+  }
+
+  return CUtils::FormatString(
+    "%s: %s (errno %d, %zu frame(s) sent)",
+    (lpszOperation ? lpszOperation : "?"),
+    strerror(iError),
+    iError,
+    nFrames
+  );
+}
+
+CGPIOWireSession::CGPIOWireSession(const string& sDevice)
+  : m_sDevice(sDevice)
+  , m_iHandle(-1)
+  , m_LastResult({ 0, NULL, 0 })
+{
+  Open();
+}
+
+CGPIOWireSession::~CGPIOWireSession()
+{
+  Close();
+}
+
+CGPIOWireSession::CGPIOWireSession(CGPIOWireSession&& Session) noexcept
+  : m_sDevice(move(Session.m_sDevice))
+  , m_iHandle(Session.m_iHandle)
+  , m_LastResult(Session.m_LastResult)
+  , m_lpFrames(move(Session.m_lpFrames))
+{
+  Session.m_iHandle = -1;
+}
+
+CGPIOWireSession& CGPIOWireSession::operator=(
+  CGPIOWireSession&& Session
+) noexcept
+{
+  if (this != &Session)
+  {
+    Close();
+
+    m_sDevice    = move(Session.m_sDevice);
+    m_iHandle    = Session.m_iHandle;
+    m_LastResult = Session.m_LastResult;
+    m_lpFrames   = move(Session.m_lpFrames);
+
+    Session.m_iHandle = -1;
+  }
+
+  return *this;
+}
+
+bool CGPIOWireSession::IsOpen() const
+{
+  return (-1 != m_iHandle);
+}
+
+const string& CGPIOWireSession::GetDevice() const
+{
+  return m_sDevice;
+}
+
+SGPIOWireResult CGPIOWireSession::GetLastResult() const
+{
+  return m_LastResult;
+}
+
+SGPIOWireResult CGPIOWireSession::Open()
+{
+  m_iHandle = open(m_sDevice.c_str(), O_WRONLY);
+
+  if (-1 == m_iHandle)
+  {
+    return SetResult(errno, "open", 0);
+  }
+
+  return SetResult(0, NULL, 0);
+}
+
+void CGPIOWireSession::Close()
+{
+  if (-1 != m_iHandle)
+  {
+    close(m_iHandle);
+    m_iHandle = -1;
+  }
+}
+
+SGPIOWireResult CGPIOWireSession::Reconnect()
+{
+  Close();
+
+  return Open();
+}
+
+SGPIOWireResult CGPIOWireSession::SendMessage(
+  const unsigned char* lpMessage,
+  size_t               nSize
+)
+{
+  return SendMessages(&lpMessage, &nSize, 1);
+}
+
+SGPIOWireResult CGPIOWireSession::SendMessages(
+  const unsigned char* const* lpMessages,
+  const size_t*               lpSizes,
+  size_t                      nCount
+)
+{
+  assert(lpMessages);
+  assert(lpSizes);
+
+  if (-1 == m_iHandle)
+  {
+    return SetResult(EBADF, "writev", 0);
+  }
+
+  if (!nCount)
+  {
+    return SetResult(0, NULL, 0);
+  }
+
+  // No heap operation for usual bursts (single frames included), larger
+  // ones are written by chunks of IOV_MAX frames
+
+  size_t        nChunk = min(nCount, (size_t)IOV_MAX);
+  struct iovec  lpStackFrames[DEF_GPIO_SESSION_STACK_FRAMES];
+  struct iovec* lpFrames = lpStackFrames;
+
+  if (nChunk > DEF_GPIO_SESSION_STACK_FRAMES)
+  {
+    if (m_lpFrames.size() < nChunk)
+    {
+      m_lpFrames.resize(nChunk);
+    }
+
+    lpFrames = m_lpFrames.data();
+  }
+
+  size_t nSent = 0;
+
+  while (nSent < nCount)
+  {
+    size_t nFrames = min((nCount - nSent), nChunk);
+    size_t nEnd    = (nSent + nFrames);
+
+    for (size_t nIndex = 0; nIndex < nFrames; nIndex++)
+    {
+      lpFrames[nIndex].iov_base = (void *)lpMessages[nSent + nIndex];
+      lpFrames[nIndex].iov_len  = lpSizes[nSent + nIndex];
+    }
+
+    ssize_t nBytesWritten = writev(m_iHandle, lpFrames, nFrames);
+
+    if (-1 == nBytesWritten)
+    {
+      return SetResult(errno, "writev", nSent);
+    }
+
+    // The module only accounts frames which have been completely transmitted.
+
+    while (
+         (nSent < nEnd)
+      && ((size_t)nBytesWritten >= lpSizes[nSent])
+    )
+    {
+      nBytesWritten -= lpSizes[nSent];
+      nSent++;
+    }
+
+    // A short write means the transmission has been interrupted
+
+    if (nSent < nEnd)
+    {
+      return SetResult(EINTR, "writev", nSent);
+    }
+  }
+
+  return SetResult(0, "writev", nSent);
+}
+
+SGPIOWireResult CGPIOWireSession::SetResult(
+  int         iError,
+  const char* lpszOperation,
+  size_t      nFrames
+)
+{
+  m_LastResult.iError        = iError;
+  m_LastResult.lpszOperation = (iError ? lpszOperation : NULL);
+  m_LastResult.nFrames       = nFrames;
+
+  return m_LastResult;
+}
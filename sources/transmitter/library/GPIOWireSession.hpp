@@ -0,0 +1,108 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef _GPIO_WIRE_SESSION_HPP_
+#define _GPIO_WIRE_SESSION_HPP_
+
+#include <stddef.h>
+
+#include <sys/uio.h>
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+#define DEF_GPIO_SESSION_STACK_FRAMES 64 // Bursts chained without allocating
+
+// Outcome of a session operation: errno and failed operation on error.
+
+struct SGPIOWireResult
+{
+  int         iError;        // errno, 0 on success
+  const char* lpszOperation; // "open", "write", "writev" (NULL on success)
+  size_t      nFrames;       // Frames completely transmitted
+
+  explicit operator bool() const
+  {
+    return (0 == iError);
+  }
+
+  string GetDescription() const;
+};
+
+// Keeps the device open across sends: the module sets the GPIO up at open
+// and releases it at close, so a per frame open/close costs two system
+// calls and a whole GPIO setup. Move only, the handle is closed by the
+// destructor.
+
+class CGPIOWireSession
+{
+public:
+  explicit CGPIOWireSession(const string& sDevice);
+  ~CGPIOWireSession();
+
+  CGPIOWireSession(const CGPIOWireSession&)            = delete;
+  CGPIOWireSession& operator=(const CGPIOWireSession&) = delete;
+
+  CGPIOWireSession(CGPIOWireSession&& Session) noexcept;
+  CGPIOWireSession& operator=(CGPIOWireSession&& Session) noexcept;
+
+  bool            IsOpen() const;
+  const string&   GetDevice() const;
+
+  // Result of the last operation (the constructor opens the device).
+
+  SGPIOWireResult GetLastResult() const;
+
+  // Closes and opens the device again, e.g. after a failed send.
+
+  SGPIOWireResult Reconnect();
+  void            Close();
+
+  SGPIOWireResult SendMessage(const unsigned char* lpMessage, size_t nSize);
+
+  // Sends a burst of frames by a single vectored write (one per IOV_MAX
+  // frames for larger bursts).
+
+  SGPIOWireResult SendMessages(
+    const unsigned char* const* lpMessages,
+    const size_t*               lpSizes,
+    size_t                      nCount
+  );
+
+private:
+  string          m_sDevice;
+  int             m_iHandle;
+  SGPIOWireResult m_LastResult;
+
+  // Larger bursts (grown only)
+
+  vector<struct iovec> m_lpFrames;
+
+  SGPIOWireResult Open();
+  SGPIOWireResult SetResult(
+    int         iError,
+    const char* lpszOperation,
+    size_t      nFrames
+  );
+};
+
+#endif /* _GPIO_WIRE_SESSION_HPP_ */
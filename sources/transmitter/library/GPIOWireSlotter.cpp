@@ -0,0 +1,145 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <assert.h>
+#include <time.h>
+
+#include <algorithm>
+
+#include "GPIOWireSlotter.hpp"
+
+CGPIOWireSlotter::CGPIOWireSlotter(
+  CGPIOWire&               GPIOWire,
+  const SGPIOWireSlotting& Slotting,
+  uint32_t                 uiSeed
+)
+  : m_GPIOWire(GPIOWire)
+  , m_Slotting(Slotting)
+  , m_Random(uiSeed ? uiSeed : random_device()())
+{
+  // Each copy needs a slot of its own
+
+  m_Slotting.uiSlotCount = max(
+    m_Slotting.uiSlotCount,
+    (m_Slotting.uiRepeatCount + 1)
+  );
+
+  m_lpSlots.resize(m_Slotting.uiSlotCount);
+}
+
+const SGPIOWireSlotting& CGPIOWireSlotter::GetSlotting() const
+{
+  return m_Slotting;
+}
+
+unsigned long CGPIOWireSlotter::GetSlotTime(unsigned long ulAirTime) const
+{
+  return max(m_Slotting.ulSlotTime, (ulAirTime + m_Slotting.ulGuardTime));
+}
+
+void CGPIOWireSlotter::Plan(
+  unsigned long     ulAirTime,
+  vector<uint64_t>& lpOffsets
+)
+{
+  unsigned long ulSlotTime = GetSlotTime(ulAirTime);
+  unsigned int  uiCopies   = (m_Slotting.uiRepeatCount + 1);
+
+  // Partial Fisher-Yates: the first uiCopies slots are distinct and random
+
+  for (uint32_t uiSlot = 0; uiSlot < m_lpSlots.size(); uiSlot++)
+  {
+    m_lpSlots[uiSlot] = uiSlot;
+  }
+
+  for (unsigned int uiCopy = 0; uiCopy < uiCopies; uiCopy++)
+  {
+    uniform_int_distribution<uint32_t> Slot(uiCopy, (m_lpSlots.size() - 1));
+
+    swap(m_lpSlots[uiCopy], m_lpSlots[Slot(m_Random)]);
+  }
+
+  sort(m_lpSlots.begin(), (m_lpSlots.begin() + uiCopies));
+
+  uniform_int_distribution<unsigned long> Jitter(0, (ulSlotTime - ulAirTime));
+
+  lpOffsets.resize(uiCopies);
+
+  for (unsigned int uiCopy = 0; uiCopy < uiCopies; uiCopy++)
+  {
+    lpOffsets[uiCopy] = (
+        ((uint64_t)m_lpSlots[uiCopy] * ulSlotTime)
+      + Jitter(m_Random)
+    );
+  }
+}
+
+SGPIOWireResult CGPIOWireSlotter::SendMessage(
+  CGPIOWireSession&    Session,
+  const unsigned char* lpMessage,
+  size_t               nSize
+)
+{
+  struct timespec Start;
+
+  clock_gettime(CLOCK_MONOTONIC, &Start);
+
+  Plan(m_GPIOWire.GetAirTime(lpMessage, nSize), m_lpOffsets);
+
+  SGPIOWireResult Result = { 0, NULL, 0 };
+
+  for (size_t nCopy = 0; nCopy < m_lpOffsets.size(); nCopy++)
+  {
+    // Absolute wake up time, so that late copies are sent at once
+
+    uint64_t        ulNanoSeconds = (Start.tv_nsec + (m_lpOffsets[nCopy] * 1000));
+    struct timespec Time          = {
+      (time_t)(Start.tv_sec + (ulNanoSeconds / 1000000000)),
+      (long)(ulNanoSeconds % 1000000000)
+    };
+
+    while (EINTR == clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &Time, NULL))
+    {
+      // Interrupted by a signal
+    }
+
+    SGPIOWireResult CopyResult = Session.SendMessage(lpMessage, nSize);
+
+    if (CopyResult)
+    {
+      Result.nFrames++;
+    }
+    else
+    {
+      Result.iError        = CopyResult.iError;
+      Result.lpszOperation = CopyResult.lpszOperation;
+    }
+  }
+
+  // Delivered if any copy was sent
+
+  if (Result.nFrames)
+  {
+    Result.iError        = 0;
+    Result.lpszOperation = NULL;
+  }
+
+  return Result;
+}
@@ -0,0 +1,89 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef _GPIO_WIRE_SLOTTER_HPP_
+#define _GPIO_WIRE_SLOTTER_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <random>
+#include <vector>
+
+#include <GPIOWire.hpp>
+#include <GPIOWireSession.hpp>
+
+using namespace std;
+
+#define DEF_GPIO_SLOT_COUNT  8
+#define DEF_GPIO_SLOT_GUARD  2000 // uS
+
+struct SGPIOWireSlotting
+{
+  unsigned int  uiSlotCount;   // Slots per frame window
+  unsigned int  uiRepeatCount; // Extra copies, each one in a distinct slot
+  unsigned long ulGuardTime;   // uS, slack added to the air time
+  unsigned long ulSlotTime;    // uS, 0 = frame air time plus guard time
+};
+
+// Randomized slotting for uncoordinated transmitters sharing a channel with
+// no carrier sense: the copies of a frame start in distinct slots, drawn at
+// random from a window of uiSlotCount slots following the send request, at
+// a random offset within the slot slack. Unlike the module repetitions
+// (fixed gap), two transmitters colliding once are unlikely to collide on
+// the other copies too. Module repetitions should be disabled then.
+//
+// See tools/Simulator.cpp to predict the delivered frame rate.
+
+class CGPIOWireSlotter
+{
+public:
+  CGPIOWireSlotter(
+    CGPIOWire&               GPIOWire,
+    const SGPIOWireSlotting& Slotting,
+    uint32_t                 uiSeed = 0 // 0 = random
+  );
+
+  const SGPIOWireSlotting& GetSlotting() const;
+
+  unsigned long GetSlotTime(unsigned long ulAirTime) const;
+
+  // Start offsets (uS, ascending) of the copies of a frame.
+
+  void Plan(unsigned long ulAirTime, vector<uint64_t>& lpOffsets);
+
+  // Sends all the copies in their slots, blocking until the last one is
+  // sent (nFrames counts the copies sent).
+
+  SGPIOWireResult SendMessage(
+    CGPIOWireSession&    Session,
+    const unsigned char* lpMessage,
+    size_t               nSize
+  );
+
+private:
+  CGPIOWire&        m_GPIOWire;
+  SGPIOWireSlotting m_Slotting;
+  mt19937           m_Random;
+  vector<uint64_t>  m_lpOffsets;
+  vector<uint32_t>  m_lpSlots;
+};
+
+#endif /* _GPIO_WIRE_SLOTTER_HPP_ */
@@ -0,0 +1,175 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef _STATIC_MESSAGE_HPP_
+#define _STATIC_MESSAGE_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <array>
+
+#include <GPIOWire.hpp>
+#include <Utils.hpp>
+
+using namespace std;
+
+// Compile time frames (STX, payload, CRC, ETX, as built by
+// CGPIOWire::CreateMessage() without FEC, compression, addressing and
+// length prefix), e.g.:
+//
+//   static constexpr auto lpHeartbeat = CreateStaticMessage("HEARTBEAT");
+//
+//   GPIOWire.SendMessage(lpHeartbeat.data(), lpHeartbeat.size());
+
+constexpr uint16_t StaticCRC16(
+  const char* lpData,
+  size_t      nSize,
+  uint16_t    nCRC = 0xFFFF
+)
+{
+  // Same as CUtils::CRC16Bitwise()
+
+  while (nSize--)
+  {
+    uint8_t nTemp  = ((nCRC >> 8) ^ (uint8_t)*lpData++);
+    nTemp         ^= (nTemp >> 4);
+
+    nCRC = (uint16_t)(
+        (nCRC << 8)
+      ^ ((uint16_t)(nTemp << 12))
+      ^ ((uint16_t)(nTemp <<  5))
+      ^ ((uint16_t)nTemp)
+    );
+  }
+
+  return nCRC;
+}
+
+static_assert(0x29B1 == StaticCRC16("123456789", 9), "Bad CRC-CCITT.");
+
+constexpr size_t GetStaticMessageSize(size_t nPayloadSize, bool bCRC)
+{
+  return (1 + nPayloadSize + (bCRC ? 2 : 0) + 1);
+}
+
+template <
+  bool   bCRC = true,
+  char   cSTX = DEF_GPIO_ENCODER_STX,
+  char   cETX = DEF_GPIO_ENCODER_ETX,
+  size_t N
+>
+constexpr array<unsigned char, GetStaticMessageSize(N - 1, bCRC)>
+CreateStaticMessage(const char (&lpszData)[N])
+{
+  array<unsigned char, GetStaticMessageSize(N - 1, bCRC)> lpMessage {};
+
+  size_t nIndex = 0;
+
+  lpMessage[nIndex++] = cSTX;
+
+  for (size_t nChar = 0; nChar < (N - 1); nChar++)
+  {
+    lpMessage[nIndex++] = lpszData[nChar];
+  }
+
+  if (bCRC)
+  {
+    uint16_t nCRC = StaticCRC16(lpszData, (N - 1));
+
+    lpMessage[nIndex++] = ((nCRC >> 8) & 0xFF);
+    lpMessage[nIndex++] = (nCRC & 0xFF);
+  }
+
+  lpMessage[nIndex] = cETX;
+
+  return lpMessage;
+}
+
+// Partly variable frames: STX and a constant prefix, with the CRC state
+// after them, are computed at compile time, e.g.:
+//
+//   static constexpr auto Prefix = CreateStaticPrefix("TEMP=");
+//
+//   size_t nSize = Prefix.CreateMessage(lpszValue, nLength, lpBuffer);
+
+template <size_t N, char cETX>
+struct SStaticPrefix
+{
+  array<unsigned char, N> lpData; // STX + prefix
+  uint16_t                nCRC;   // CRC state after the prefix
+
+  static constexpr size_t GetMessageSize(size_t nSize)
+  {
+    return (N + nSize + 2 + 1);
+  }
+
+  // Writes the whole frame into lpBuffer (GetMessageSize() bytes), without
+  // allocating, and returns its size.
+
+  size_t CreateMessage(
+    const char*    lpData,
+    size_t         nSize,
+    unsigned char* lpBuffer
+  ) const
+  {
+    memcpy(lpBuffer, this->lpData.data(), N);
+    memcpy((lpBuffer + N), lpData, nSize);
+
+    uint16_t nCRC = CUtils::CRC16(
+      (const unsigned char *)lpData,
+      nSize,
+      this->nCRC
+    );
+
+    lpBuffer[N + nSize]     = ((nCRC >> 8) & 0xFF);
+    lpBuffer[N + nSize + 1] = (nCRC & 0xFF);
+    lpBuffer[N + nSize + 2] = cETX;
+
+    return GetMessageSize(nSize);
+  }
+};
+
+template <
+  char   cSTX = DEF_GPIO_ENCODER_STX,
+  char   cETX = DEF_GPIO_ENCODER_ETX,
+  size_t N
+>
+constexpr SStaticPrefix<N, cETX>
+CreateStaticPrefix(const char (&lpszPrefix)[N])
+{
+  // N - 1 prefix chars + STX
+
+  SStaticPrefix<N, cETX> Prefix {};
+
+  Prefix.lpData[0] = cSTX;
+
+  for (size_t nChar = 0; nChar < (N - 1); nChar++)
+  {
+    Prefix.lpData[1 + nChar] = lpszPrefix[nChar];
+  }
+
+  Prefix.nCRC = StaticCRC16(lpszPrefix, (N - 1));
+
+  return Prefix;
+}
+
+#endif /* _STATIC_MESSAGE_HPP_ */
@@ -0,0 +1,237 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <assert.h>
+#include <string.h>
+
+#include "Telemetry.hpp"
+
+static inline uint32_t ZigZag(int32_t iValue)
+{
+  return (((uint32_t)iValue << 1) ^ (uint32_t)(iValue >> 31));
+}
+
+CTelemetryEncoder::CTelemetryEncoder(
+  const STelemetryField* lpSchema,
+  size_t                 nFields,
+  unsigned int           uiKeyInterval,
+  bool                   bFrameKey
+)
+  : m_lpSchema(lpSchema)
+  , m_nFields(nFields)
+  , m_uiKeyInterval(uiKeyInterval)
+  , m_bFrameKey(bFrameKey)
+  , m_lpLastValues(nFields, 0)
+  , m_uiSinceKey(0)
+  , m_bNeedKey(true)
+  , m_lpBuffer(NULL)
+  , m_nSize(0)
+  , m_nBitIndex(0)
+  , m_nRecords(0)
+{
+  assert(lpSchema);
+  assert(nFields > 0);
+
+  for (size_t nIndex = 0; nIndex < nFields; nIndex++)
+  {
+    assert((lpSchema[nIndex].nBits > 0) && (lpSchema[nIndex].nBits <= 32));
+  }
+}
+
+void CTelemetryEncoder::Begin(unsigned char* lpBuffer, size_t nSize)
+{
+  assert(lpBuffer);
+  assert(nSize > 0);
+
+  m_lpBuffer  = lpBuffer;
+  m_nSize     = nSize;
+  m_nBitIndex = 8; // Record count
+  m_nRecords  = 0;
+
+  memset(lpBuffer, 0, nSize);
+
+  if (m_bFrameKey)
+  {
+    m_bNeedKey = true;
+  }
+}
+
+bool CTelemetryEncoder::Add(const int32_t* lpValues)
+{
+  assert(m_lpBuffer);
+  assert(lpValues);
+
+  if (m_nRecords >= TELEMETRY_MAX_RECORDS)
+  {
+    return false;
+  }
+
+  size_t nBitIndex = m_nBitIndex;
+  bool   bKey      = (
+       m_bNeedKey
+    || ((m_uiKeyInterval > 0) && (m_uiSinceKey >= m_uiKeyInterval))
+  );
+
+  if (!WriteRecord(lpValues, bKey))
+  {
+    // Some delta did not fit its field (or the buffer is full, or some
+    // absolute value does not fit its field): retry as key
+
+    m_nBitIndex = nBitIndex;
+
+    if (bKey || !WriteRecord(lpValues, true))
+    {
+      m_nBitIndex = nBitIndex;
+
+      // Clear the partially written bits
+
+      for (size_t nBit = nBitIndex; nBit < (m_nSize * 8); nBit++)
+      {
+        m_lpBuffer[nBit / 8] &= ~(0x80 >> (nBit % 8));
+      }
+
+      return false;
+    }
+
+    bKey = true;
+  }
+
+  memcpy(m_lpLastValues.data(), lpValues, (sizeof(int32_t) * m_nFields));
+
+  m_uiSinceKey = (bKey ? 1 : (m_uiSinceKey + 1));
+  m_bNeedKey   = false;
+
+  m_nRecords++;
+
+  return true;
+}
+
+size_t CTelemetryEncoder::End()
+{
+  assert(m_lpBuffer);
+
+  m_lpBuffer[0] = m_nRecords;
+
+  return ((m_nBitIndex + 7) / 8);
+}
+
+void CTelemetryEncoder::Reset()
+{
+  m_bNeedKey = true;
+}
+
+bool CTelemetryEncoder::Write(uint32_t nValue, uint8_t nBits)
+{
+  if ((m_nBitIndex + nBits) > (m_nSize * 8))
+  {
+    return false;
+  }
+
+  while (nBits--)
+  {
+    if ((nValue >> nBits) & 1)
+    {
+      m_lpBuffer[m_nBitIndex / 8] |= (0x80 >> (m_nBitIndex % 8));
+    }
+    else
+    {
+      m_lpBuffer[m_nBitIndex / 8] &= ~(0x80 >> (m_nBitIndex % 8));
+    }
+
+    m_nBitIndex++;
+  }
+
+  return true;
+}
+
+bool CTelemetryEncoder::WriteField(
+  const STelemetryField& Field,
+  uint32_t               nValue
+)
+{
+  if (Field.nFlags & TELEMETRY_VARINT)
+  {
+    uint32_t nMask = (
+      (Field.nBits < 32) ? ((1UL << Field.nBits) - 1) : 0xFFFFFFFF
+    );
+
+    do
+    {
+      uint32_t nGroup = (nValue & nMask);
+
+      nValue = ((Field.nBits < 32) ? (nValue >> Field.nBits) : 0);
+
+      if (!Write((nValue ? 1 : 0), 1) || !Write(nGroup, Field.nBits))
+      {
+        return false;
+      }
+    }
+    while (nValue);
+
+    return true;
+  }
+
+  if ((Field.nBits < 32) && (nValue >> Field.nBits))
+  {
+    return false;
+  }
+
+  return Write(nValue, Field.nBits);
+}
+
+bool CTelemetryEncoder::WriteRecord(const int32_t* lpValues, bool bKey)
+{
+  if (!Write((bKey ? 1 : 0), 1))
+  {
+    return false;
+  }
+
+  for (size_t nIndex = 0; nIndex < m_nFields; nIndex++)
+  {
+    const STelemetryField& Field = m_lpSchema[nIndex];
+    uint32_t               nValue;
+
+    if (!bKey && (Field.nFlags & TELEMETRY_DELTA))
+    {
+      nValue = ZigZag((int32_t)(
+          (uint32_t)lpValues[nIndex]
+        - (uint32_t)m_lpLastValues[nIndex]
+      ));
+    }
+    else
+    {
+      nValue = (
+        (Field.nFlags & TELEMETRY_SIGNED)
+          ? ZigZag(lpValues[nIndex])
+          : (uint32_t)lpValues[nIndex]
+      );
+    }
+
+    // Values wider than their field are rejected, never truncated: the
+    // next deltas are computed against them
+
+    if (!WriteField(Field, nValue))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
@@ -0,0 +1,104 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef _TELEMETRY_HPP_
+#define _TELEMETRY_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+using namespace std;
+
+// Schema driven bit packed telemetry records.
+//
+// Frame layout: record count (8 bits), then bit packed records (MSB first),
+// zero padded to the byte. Each record starts with a key flag bit: key
+// records carry absolute values, the others carry TELEMETRY_DELTA fields as
+// differences against the previous record. Fields are "nBits" wide, or
+// groups of "nBits" bits each preceded by a continuation bit when
+// TELEMETRY_VARINT is set. Signed values and deltas are zig-zag encoded.
+//
+// Payloads are binary: send them with FEC or length prefixed frames (no
+// STX/ETX collision possible).
+
+#define TELEMETRY_SIGNED      1
+#define TELEMETRY_DELTA       2
+#define TELEMETRY_VARINT      4
+
+#define TELEMETRY_MAX_RECORDS 255
+
+struct STelemetryField
+{
+  uint8_t nBits;
+  uint8_t nFlags;
+};
+
+class CTelemetryEncoder
+{
+public:
+  // A key record is sent every uiKeyInterval records (and as first record
+  // of each frame when bFrameKey is set, so every frame decodes alone).
+
+  CTelemetryEncoder(
+    const STelemetryField* lpSchema,
+    size_t                 nFields,
+    unsigned int           uiKeyInterval,
+    bool                   bFrameKey = true
+  );
+
+  void   Begin(unsigned char* lpBuffer, size_t nSize);
+
+  // Returns false (and leaves the frame untouched) when the record does not
+  // fit into the buffer anymore, or when some value does not fit its field
+  // (absolute values are never truncated).
+
+  bool   Add(const int32_t* lpValues);
+
+  // Returns the frame size.
+
+  size_t End();
+
+  // Forces next record to be a key one.
+
+  void   Reset();
+
+private:
+  const STelemetryField* m_lpSchema;
+  size_t                 m_nFields;
+  unsigned int           m_uiKeyInterval;
+  bool                   m_bFrameKey;
+
+  vector<int32_t>        m_lpLastValues;
+  unsigned int           m_uiSinceKey;
+  bool                   m_bNeedKey;
+
+  unsigned char*         m_lpBuffer;
+  size_t                 m_nSize;
+  size_t                 m_nBitIndex;
+  size_t                 m_nRecords;
+
+  bool Write(uint32_t nValue, uint8_t nBits);
+  bool WriteField(const STelemetryField& Field, uint32_t nValue);
+  bool WriteRecord(const int32_t* lpValues, bool bKey);
+};
+
+#endif /* _TELEMETRY_HPP_ */
@@ -21,19 +21,22 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <assert.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "Utils.hpp"
 
-uint16_t CUtils::CRC16(const unsigned char* lpData, size_t nSize)
+uint16_t CUtils::CRC16Bitwise(
+  const unsigned char* lpData,
+  size_t               nSize,
+  uint16_t             nCRC
+)
 {
   // https://stackoverflow.com/questions/10564491/function-to-calculate-a-crc16-checksum
   // https://www.lammertbies.nl/comm/info/crc-calculation.html
 
   // CRC-CCITT (0xFFFF)
 
-  uint16_t nCRC = 0xFFFF;
-
   while (nSize--)
   {
       uint8_t nTemp  = (nCRC  >> 8) ^ *lpData++;
@@ -62,6 +65,15 @@ bool CUtils::FileExists(const string& sFileName)
   return FileExists(sFileName.c_str());
 }
 
+uint64_t CUtils::GetMonotonicTime()
+{
+  struct timespec Time;
+
+  clock_gettime(CLOCK_MONOTONIC, &Time);
+
+  return ((uint64_t)Time.tv_sec * 1000) + (Time.tv_nsec / 1000000);
+}
+
 const string CUtils::FormatString(const char* lpszFormat, va_list lpArgs)
 {
   assert(lpszFormat);
@@ -56,12 +56,54 @@ public:
   // ***********
   static bool FileExists(const char* lpszFileName);
   static bool FileExists(const string& sFileName);    
+
+  // ****
+  // Time
+  // ****
+
+  static uint64_t GetMonotonicTime(); // mS
   
   // ****
   // Math
   // ****
   
-  static uint16_t CRC16(const unsigned char* lpData, size_t nSize);
+  // CRC-CCITT, pass a previous result as nCRC to continue it. The fastest
+  // implementation supported by the CPU is selected at first call.
+
+  static uint16_t CRC16(
+    const unsigned char* lpData,
+    size_t               nSize,
+    uint16_t             nCRC = 0xFFFF
+  );
+
+  // Implementations (see UtilsCRC16.cpp), CRC16CLMul() requires
+  // HasCRC16CLMul().
+
+  static uint16_t CRC16Bitwise(
+    const unsigned char* lpData,
+    size_t               nSize,
+    uint16_t             nCRC = 0xFFFF
+  );
+
+  static uint16_t CRC16Table(
+    const unsigned char* lpData,
+    size_t               nSize,
+    uint16_t             nCRC = 0xFFFF
+  );
+
+  static uint16_t CRC16Slice8(
+    const unsigned char* lpData,
+    size_t               nSize,
+    uint16_t             nCRC = 0xFFFF
+  );
+
+  static uint16_t CRC16CLMul(
+    const unsigned char* lpData,
+    size_t               nSize,
+    uint16_t             nCRC = 0xFFFF
+  );
+
+  static bool     HasCRC16CLMul();
 };
 
 #endif /* _UTILS_HPP_ */
\ No newline at end of file
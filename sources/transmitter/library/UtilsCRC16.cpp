@@ -0,0 +1,287 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <assert.h>
+
+#include "Utils.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+  #include <immintrin.h>
+
+  #define CRC16_CLMUL_SUPPORTED
+  #define CRC16_CLMUL_TARGET __attribute__((target("pclmul,ssse3")))
+#endif
+
+// CRC-CCITT (0xFFFF): polynomial 0x1021, MSB first, no final XOR.
+
+#define CRC16_POLYNOMIAL 0x1021
+
+struct SCRC16Tables
+{
+  uint16_t lpTables[8][256]; // [N] = byte followed by N zero bytes
+
+  SCRC16Tables()
+  {
+    for (unsigned int nByte = 0; nByte < 256; nByte++)
+    {
+      uint16_t nCRC = (nByte << 8);
+
+      for (int iBit = 0; iBit < 8; iBit++)
+      {
+        nCRC = ((nCRC & 0x8000) ? ((nCRC << 1) ^ CRC16_POLYNOMIAL) : (nCRC << 1));
+      }
+
+      lpTables[0][nByte] = nCRC;
+    }
+
+    for (int iTable = 1; iTable < 8; iTable++)
+    {
+      for (unsigned int nByte = 0; nByte < 256; nByte++)
+      {
+        uint16_t nCRC = lpTables[iTable - 1][nByte];
+
+        lpTables[iTable][nByte] = ((nCRC << 8) ^ lpTables[0][nCRC >> 8]);
+      }
+    }
+  }
+};
+
+static const SCRC16Tables& GetCRC16Tables()
+{
+  static const SCRC16Tables Tables;
+
+  return Tables;
+}
+
+uint16_t CUtils::CRC16Table(
+  const unsigned char* lpData,
+  size_t               nSize,
+  uint16_t             nCRC
+)
+{
+  const uint16_t* lpTable = GetCRC16Tables().lpTables[0];
+
+  while (nSize--)
+  {
+    nCRC = ((nCRC << 8) ^ lpTable[(nCRC >> 8) ^ *lpData++]);
+  }
+
+  return nCRC;
+}
+
+uint16_t CUtils::CRC16Slice8(
+  const unsigned char* lpData,
+  size_t               nSize,
+  uint16_t             nCRC
+)
+{
+  const uint16_t (*lpTables)[256] = GetCRC16Tables().lpTables;
+
+  // The CRC only overlaps the first two bytes of each 8 bytes block
+
+  while (nSize >= 8)
+  {
+    nCRC =
+        lpTables[7][lpData[0] ^ (nCRC >> 8)]
+      ^ lpTables[6][lpData[1] ^ (nCRC & 0xFF)]
+      ^ lpTables[5][lpData[2]]
+      ^ lpTables[4][lpData[3]]
+      ^ lpTables[3][lpData[4]]
+      ^ lpTables[2][lpData[5]]
+      ^ lpTables[1][lpData[6]]
+      ^ lpTables[0][lpData[7]]
+    ;
+
+    lpData += 8;
+    nSize  -= 8;
+  }
+
+  return CRC16Table(lpData, nSize, nCRC);
+}
+
+#ifdef CRC16_CLMUL_SUPPORTED
+
+// x^N mod P, used as folding constants.
+
+static uint64_t CRC16PowerMod(unsigned int nPower)
+{
+  uint32_t nValue = 1;
+
+  while (nPower--)
+  {
+    nValue <<= 1;
+
+    if (nValue & 0x10000)
+    {
+      nValue ^= (0x10000 | CRC16_POLYNOMIAL);
+    }
+  }
+
+  return nValue;
+}
+
+CRC16_CLMUL_TARGET
+static inline __m128i CRC16Fold(__m128i Value, __m128i Constants)
+{
+  // Value * x^128 mod P ~ high * (x^192 mod P) + low * (x^128 mod P)
+
+  return _mm_xor_si128(
+    _mm_clmulepi64_si128(Value, Constants, 0x11),
+    _mm_clmulepi64_si128(Value, Constants, 0x00)
+  );
+}
+
+CRC16_CLMUL_TARGET
+uint16_t CUtils::CRC16CLMul(
+  const unsigned char* lpData,
+  size_t               nSize,
+  uint16_t             nCRC
+)
+{
+  // Blocks are folded as 128 bits big endian polynomials (congruent to the
+  // data modulo P), then the remainder is got by the table implementation.
+
+  if (nSize < 64)
+  {
+    return CRC16Slice8(lpData, nSize, nCRC);
+  }
+
+  static const __m128i Fold128 = _mm_set_epi64x(
+    CRC16PowerMod(192),
+    CRC16PowerMod(128)
+  );
+
+  static const __m128i Fold512 = _mm_set_epi64x(
+    CRC16PowerMod(576),
+    CRC16PowerMod(512)
+  );
+
+  const __m128i Swap = _mm_set_epi8(
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15
+  );
+
+  __m128i Blocks[4];
+
+  for (int iBlock = 0; iBlock < 4; iBlock++)
+  {
+    Blocks[iBlock] = _mm_shuffle_epi8(
+      _mm_loadu_si128((const __m128i*)(lpData + (iBlock * 16))),
+      Swap
+    );
+  }
+
+  // The initial CRC is XOR-ed into the first two bytes
+
+  Blocks[0] = _mm_xor_si128(
+    Blocks[0],
+    _mm_set_epi64x(((uint64_t)nCRC << 48), 0)
+  );
+
+  lpData += 64;
+  nSize  -= 64;
+
+  while (nSize >= 64)
+  {
+    for (int iBlock = 0; iBlock < 4; iBlock++)
+    {
+      Blocks[iBlock] = _mm_xor_si128(
+        CRC16Fold(Blocks[iBlock], Fold512),
+        _mm_shuffle_epi8(
+          _mm_loadu_si128((const __m128i*)(lpData + (iBlock * 16))),
+          Swap
+        )
+      );
+    }
+
+    lpData += 64;
+    nSize  -= 64;
+  }
+
+  __m128i Value = Blocks[0];
+
+  for (int iBlock = 1; iBlock < 4; iBlock++)
+  {
+    Value = _mm_xor_si128(CRC16Fold(Value, Fold128), Blocks[iBlock]);
+  }
+
+  while (nSize >= 16)
+  {
+    Value = _mm_xor_si128(
+      CRC16Fold(Value, Fold128),
+      _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)lpData), Swap)
+    );
+
+    lpData += 16;
+    nSize  -= 16;
+  }
+
+  unsigned char lpValue[16];
+
+  _mm_storeu_si128((__m128i*)lpValue, _mm_shuffle_epi8(Value, Swap));
+
+  return CRC16Slice8(lpData, nSize, CRC16Slice8(lpValue, 16, 0));
+}
+
+bool CUtils::HasCRC16CLMul()
+{
+  __builtin_cpu_init();
+
+  return (
+       __builtin_cpu_supports("pclmul")
+    && __builtin_cpu_supports("ssse3")
+  );
+}
+
+#else
+
+uint16_t CUtils::CRC16CLMul(
+  const unsigned char* lpData,
+  size_t               nSize,
+  uint16_t             nCRC
+)
+{
+  return CRC16Slice8(lpData, nSize, nCRC);
+}
+
+bool CUtils::HasCRC16CLMul()
+{
+  return false;
+}
+
+#endif
+
+uint16_t CUtils::CRC16(
+  const unsigned char* lpData,
+  size_t               nSize,
+  uint16_t             nCRC
+)
+{
+  typedef uint16_t (*CRC16Function)(const unsigned char*, size_t, uint16_t);
+
+  static const CRC16Function lpfnCRC16 = (
+      HasCRC16CLMul()
+    ? CRC16CLMul
+    : CRC16Slice8
+  );
+
+  assert(lpData || !nSize);
+
+  return lpfnCRC16(lpData, nSize, nCRC);
+}
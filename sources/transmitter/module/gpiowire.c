@@ -77,6 +77,113 @@ inline int gpio_set_pin(struct device_data* data, int value)
   return value;
 }
 
+bool prot_load_byte(struct device_data* data)
+{
+  struct prot_ctx *ctx = &data->prot_ctx;
+
+  // Frame bytes are produced on the fly, so the CRC is accumulated while
+  // the previous bytes are already being transmitted.
+
+  switch (ctx->stage)
+  {
+    case STAGE_STX:
+      ctx->byte  = data->attr_frame_stx;
+      ctx->stage = STAGE_PAYLOAD;
+
+      return true;
+
+    case STAGE_PAYLOAD:
+      ctx->byte = *ctx->message++;
+      ctx->msg_count--;
+
+      if (ctx->frame_crc)
+      {
+        ctx->crc = crc_itu_t_byte(ctx->crc, ctx->byte);
+      }
+
+      if (0 == ctx->msg_count)
+      {
+        if (!ctx->frame_encoding)
+        {
+          ctx->stage = STAGE_DONE;
+        }
+        else if (ctx->frame_crc)
+        {
+          ctx->stage = STAGE_CRC_HIGH;
+        }
+        else
+        {
+          ctx->stage = STAGE_ETX;
+        }
+      }
+
+      return true;
+
+    case STAGE_CRC_HIGH:
+      ctx->byte  = ((ctx->crc >> 8) & 0xFF);
+      ctx->stage = STAGE_CRC_LOW;
+
+      return true;
+
+    case STAGE_CRC_LOW:
+      ctx->byte  = (ctx->crc & 0xFF);
+      ctx->stage = STAGE_ETX;
+
+      return true;
+
+    case STAGE_ETX:
+      ctx->byte  = data->attr_frame_etx;
+      ctx->stage = STAGE_DONE;
+
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+int prot_byte_sync_count(struct device_data* data)
+{
+  // Per byte synchronization (default) or frame preamble plus an optional
+  // resync every "resync_interval" bytes.
+
+  if (
+       !data->prot_ctx.frame_sync
+    || (0 == data->prot_ctx.byte_index)
+    || (
+            (data->prot_ctx.resync_interval > 0)
+         && (0 == (data->prot_ctx.byte_index % data->prot_ctx.resync_interval))
+       )
+  )
+  {
+    return data->attr_sync_bit_count;
+  }
+
+  return 0;
+}
+
+void prot_rewind_frame(struct device_data* data)
+{
+  // Restart encoding from the first frame byte (the message is never
+  // modified while transmitting, so it can be replayed from memory).
+
+  data->prot_ctx.message    = data->prot_ctx.msg_start;
+  data->prot_ctx.msg_count  = data->prot_ctx.msg_len;
+
+  data->prot_ctx.crc        = 0xFFFF; // CRC-CCITT (0xFFFF)
+  data->prot_ctx.stage      = (
+      data->prot_ctx.frame_encoding
+    ? STAGE_STX
+    : STAGE_PAYLOAD
+  );
+
+  prot_load_byte(data);
+
+  data->prot_ctx.byte_index = 0;
+  data->prot_ctx.sync_count = prot_byte_sync_count(data);
+  data->prot_ctx.bit_count  = 8;
+}
+
 enum hrtimer_restart prot_write_callback(struct hrtimer *timer)
 {
   struct device_data *data = container_of(
@@ -128,49 +235,107 @@ enum hrtimer_restart prot_write_callback(struct hrtimer *timer)
 
   // Check for sequence completion
   
-  if (
-       (0 == data->prot_ctx.msg_count)
-    && (0 == data->prot_ctx.bit_count)
-  )
+  if (0 == data->prot_ctx.bit_count)
   {
     // Last edge
 
     gpio_set_pin(data, 0);
 
+    if (data->prot_ctx.repeat_count > 0)
+    {
+      // Replay the frame after the inter-repeat gap
+
+      data->prot_ctx.repeat_count--;
+
+      prot_rewind_frame(data);
+
+      data->prot_ctx.next_edge = EDGE_HIGH;
+      hrtimer_forward_now(timer, data->edge_repeat_gap);
+
+      return HRTIMER_RESTART;
+    }
+
+    // Frame completed
+
+    data->prot_ctx.frame_index++;
+
+    if (data->prot_ctx.frame_index < data->prot_ctx.frame_count)
+    {
+      // Chain the next frame after the inter-frame gap
+
+      data->prot_ctx.msg_start   += data->prot_ctx.msg_len;
+      data->prot_ctx.msg_len      =
+        data->prot_ctx.frame_lens[data->prot_ctx.frame_index];
+
+      data->prot_ctx.repeat_count = data->attr_repeat_count;
+
+      prot_rewind_frame(data);
+
+      data->prot_ctx.next_edge = EDGE_HIGH;
+      hrtimer_forward_now(timer, data->edge_frame_gap);
+
+      return HRTIMER_RESTART;
+    }
+
     // Sequence completed
 
     complete(&data->prot_ctx.sem);
     return HRTIMER_NORESTART;
   }
 
-  // Encode bit
-  
-  low_edge =
-      (128 == (*data->prot_ctx.message & 128))
-    ? data->edge_one_bit
-    : data->edge_zero_bit
-  ;
+  if (data->prot_ctx.multi_level)
+  {
+    // Encode two bits per pulse (00, 01, 10, 11)
 
-  *data->prot_ctx.message <<= 1;
+    switch (data->prot_ctx.byte & 0xC0)
+    {
+      case 0x00:
+        low_edge = data->edge_zero_bit;
+        break;
 
-  // Get next data bits
-  
-  data->prot_ctx.bit_count--;
+      case 0x40:
+        low_edge = data->edge_one_bit;
+        break;
 
-  if (0 == data->prot_ctx.bit_count)
+      case 0x80:
+        low_edge = data->edge_two_symbol;
+        break;
+
+      default:
+        low_edge = data->edge_three_symbol;
+        break;
+    }
+
+    data->prot_ctx.byte    <<= 2;
+    data->prot_ctx.bit_count -= 2;
+  }
+  else
   {
-    // Byte completed
-    
-    data->prot_ctx.msg_count--;
+    // Encode bit
+  
+    low_edge =
+        (128 == (data->prot_ctx.byte & 128))
+      ? data->edge_one_bit
+      : data->edge_zero_bit
+    ;
+
+    data->prot_ctx.byte <<= 1;
+    data->prot_ctx.bit_count--;
+  }
 
-    if (data->prot_ctx.msg_count > 0)
-    {
-      // Other bytes available...
+  // Get next data bits
+
+  if (
+       (0 == data->prot_ctx.bit_count)
+    && prot_load_byte(data)
+  )
+  {
+    // Byte completed, other bytes available...
       
-      data->prot_ctx.sync_count = data->attr_sync_bit_count;
-      data->prot_ctx.bit_count  = 8;
-      data->prot_ctx.message++;
-    }
+    data->prot_ctx.byte_index++;
+
+    data->prot_ctx.sync_count = prot_byte_sync_count(data);
+    data->prot_ctx.bit_count  = 8;
   }
 
   // Low edge
@@ -183,22 +348,51 @@ enum hrtimer_restart prot_write_callback(struct hrtimer *timer)
   return HRTIMER_RESTART;
 }
 
+size_t prot_frame_len(struct device_data* data, size_t len)
+{
+  size_t frame_len = len;
+
+  if (data->attr_frame_encoding)
+  {
+    frame_len += 2; // STX + ETX
+
+    if (data->attr_frame_crc)
+    {
+      frame_len += 2;
+    }
+  }
+
+  return frame_len;
+}
+
 inline ssize_t prot_write_message(
   struct device_data *data,
   const char         *buffer,
-  size_t             len
+  const size_t       *frame_lens,
+  size_t             frame_count
 )
 {
   // Initialization
   
   size_t  edge_count    = 0;
+  size_t  index;
+  ssize_t written       = 0;
   ktime_t tot_perf_time = ktime_set(0, 0);
   
-  if (!len)
+  if (!frame_count)
   {
     LOG_DEV(warn, "null buffer provided.\n");
     return -EINVAL;
   }
+
+  for (index = 0; index < frame_count; index++)
+  {
+    if (!frame_lens[index])
+    {
+      LOG_DEV(warn, "null frame %zu provided.\n", index);
+      return -EINVAL;
+    }
+  }
   
   if (data->attr_perf_debug)
   {
@@ -207,8 +401,22 @@ inline ssize_t prot_write_message(
     edge_count = (
         1 /* Baseline */
       + 2 /* Sequence setup pulse */
-      + ((data->attr_sync_bit_count + 8) * len * 2)
     );
+
+    for (index = 0; index < frame_count; index++)
+    {
+      edge_count += (
+          (
+              (
+                  (data->attr_sync_bit_count + 8)
+                * prot_frame_len(data, frame_lens[index])
+                * 2
+              )
+            + 2 /* Last edge / repeat or frame gap */
+          )
+        * (data->attr_repeat_count + 1)
+      );
+    }
     
     data->prot_ctx.perf_data = kzalloc(
       (sizeof(struct perf_data) * edge_count), 
@@ -222,10 +430,25 @@ inline ssize_t prot_write_message(
     } 
   }
 
-  data->prot_ctx.sync_count = data->attr_sync_bit_count;
-  data->prot_ctx.message    = (char *)buffer;
-  data->prot_ctx.msg_count  = len;
-  data->prot_ctx.bit_count  = 8;
+  data->prot_ctx.frame_lens     = frame_lens;
+  data->prot_ctx.frame_count    = frame_count;
+  data->prot_ctx.frame_index    = 0;
+
+  data->prot_ctx.msg_start      = buffer;
+  data->prot_ctx.msg_len        = frame_lens[0];
+  data->prot_ctx.repeat_count   = data->attr_repeat_count;
+
+  data->prot_ctx.frame_encoding = data->attr_frame_encoding;
+  data->prot_ctx.frame_crc      = (
+       data->attr_frame_encoding
+    && data->attr_frame_crc
+  );
+
+  data->prot_ctx.frame_sync      = data->attr_frame_sync;
+  data->prot_ctx.multi_level     = data->attr_multi_level;
+  data->prot_ctx.resync_interval = data->attr_resync_interval;
+
+  prot_rewind_frame(data);
 
   reinit_completion(&data->prot_ctx.sem);
 
@@ -251,7 +474,26 @@ inline ssize_t prot_write_message(
   // Wait for sequence completion...
 
   hrtimer_start(&data->timer, data->edge_high_state, HRTIMER_MODE_REL);
-  wait_for_completion_killable(&data->prot_ctx.sem);
+
+  if (wait_for_completion_killable(&data->prot_ctx.sem))
+  {
+    // Killed: stop transmitting, only completed frames are accounted
+
+    hrtimer_cancel(&data->timer);
+    gpio_set_pin(data, 0);
+
+    LOG_DEV(
+      warn, 
+      "transmission interrupted after %zu of %zu frame(s).\n",
+      data->prot_ctx.frame_index,
+      frame_count
+    );
+  }
+
+  for (index = 0; index < data->prot_ctx.frame_index; index++)
+  {
+    written += frame_lens[index];
+  }
 
   if (data->attr_perf_debug)
   {
@@ -267,7 +509,7 @@ inline ssize_t prot_write_message(
     kfree(data->prot_ctx.perf_data);
   }
 
-  return len;
+  return written;
 }
 
 /*****************/
@@ -540,9 +782,18 @@ int file_open(struct inode *inodep, struct file *filep)
   data->edge_one_bit = 
     ktime_set(0, ((data->attr_one_bit  - data->attr_high_state) * 1000));
 
+  data->edge_two_symbol = 
+    ktime_set(0, ((data->attr_two_symbol   - data->attr_high_state) * 1000));
+
+  data->edge_three_symbol = 
+    ktime_set(0, ((data->attr_three_symbol - data->attr_high_state) * 1000));
+
   data->edge_sync_bit = 
     ktime_set(0, ((data->attr_sync_bit - data->attr_high_state) * 1000));
 
+  data->edge_repeat_gap = ktime_set(0, (data->attr_repeat_gap * 1000));
+  data->edge_frame_gap  = ktime_set(0, (data->attr_frame_gap  * 1000));
+
   LOG_DEV(debug, "successfully opened.\n");
   return 0;
 }
@@ -570,6 +821,7 @@ ssize_t file_write(
   loff_t            *offset
 )
 {
+  ssize_t             result;
   struct device_data* data    = (struct device_data*)filep->private_data;
   char*               message = kmalloc(len, GFP_KERNEL);
     
@@ -594,13 +846,101 @@ ssize_t file_write(
     data->attr_pin_number
   );
 
-  prot_write_message(data, message, len);    
+  result = prot_write_message(data, message, &len, 1);
   kfree(message);
 
+  if (result < 0)
+  {
+    return result;
+  }
+
   LOG_DEV(debug, "buffer successfully written.\n");
   
-  *offset += len;
-  return len;
+  *offset += result;
+  return result;
+}
+
+ssize_t file_write_iter(struct kiocb *iocb, struct iov_iter *from)
+{
+  ssize_t             result;
+  size_t              index;
+  size_t              frame_count = 1;
+  size_t              len         = iov_iter_count(from);
+  size_t*             frame_lens;
+  char*               message;
+  struct device_data* data        = 
+    (struct device_data*)iocb->ki_filp->private_data;
+
+  // Each iovec is a frame: all of them are chained under a single timer run
+
+  if (iter_is_iovec(from))
+  {
+    frame_count = from->nr_segs;
+  }
+
+  frame_lens = kmalloc_array(frame_count, sizeof(size_t), GFP_KERNEL);
+
+  if (!frame_lens)
+  {
+    LOG_DEV(crit, "cannot allocate frames (%zu frames).\n", frame_count);
+    return -ENOMEM;
+  }
+
+  if (iter_is_iovec(from))
+  {
+    for (index = 0; index < frame_count; index++)
+    {
+      frame_lens[index] = GPIOWIRE_ITER_IOV(from)[index].iov_len;
+    }
+
+    frame_lens[0] -= from->iov_offset;
+  }
+  else
+  {
+    frame_lens[0] = len;
+  }
+
+  message = kmalloc(len, GFP_KERNEL);
+
+  if (!message)
+  {
+    kfree(frame_lens);
+
+    LOG_DEV(crit, "cannot allocate buffer (%zu bytes).\n", len);
+    return -ENOMEM;
+  }
+
+  if (copy_from_iter(message, len, from) != len)
+  {
+    kfree(message);
+    kfree(frame_lens);
+
+    LOG_DEV(crit, "cannot copy buffer (%zu bytes).\n", len);
+    return -EFAULT;
+  }
+
+  LOG_DEV(
+    debug, 
+    "writing %zu frame(s), %zu byte(s) to pin %d...\n", 
+    frame_count,
+    len,
+    data->attr_pin_number
+  );
+
+  result = prot_write_message(data, message, frame_lens, frame_count);
+
+  kfree(message);
+  kfree(frame_lens);
+
+  if (result < 0)
+  {
+    return result;
+  }
+
+  LOG_DEV(debug, "frames successfully written.\n");
+
+  iocb->ki_pos += result;
+  return result;
 }
 
 // Module entry/exit point
@@ -971,3 +1311,467 @@ ssize_t canSleep_store(
 
   return count;
 }
+
+ssize_t frameEncoding_show(
+  struct kobject        *kobj, 
+  struct kobj_attribute *attr, 
+  char                  *buf
+)
+{
+  struct device_data* data = kobj_to_dev_data(kobj);
+  
+  return sprintf(
+    buf, 
+    "%d\n", 
+    (data->attr_frame_encoding ? 1 : 0)
+  );
+}
+
+ssize_t frameEncoding_store(
+  struct kobject        *kobj, 
+  struct kobj_attribute *attr, 
+  const char            *buf, 
+  size_t                count)
+{
+  int                 value;
+  struct device_data* data = kobj_to_dev_data(kobj);
+
+  sscanf(buf, "%du", &value);
+
+  data->attr_frame_encoding = (1 == value);
+
+  LOG_DEV(
+    debug, 
+    "frame encoding set to %s.\n", 
+    (data->attr_frame_encoding ? "true" : "false")
+  );
+
+  return count;
+}
+
+ssize_t frameCRC_show(
+  struct kobject        *kobj, 
+  struct kobj_attribute *attr, 
+  char                  *buf
+)
+{
+  struct device_data* data = kobj_to_dev_data(kobj);
+  
+  return sprintf(
+    buf, 
+    "%d\n", 
+    (data->attr_frame_crc ? 1 : 0)
+  );
+}
+
+ssize_t frameCRC_store(
+  struct kobject        *kobj, 
+  struct kobj_attribute *attr, 
+  const char            *buf, 
+  size_t                count)
+{
+  int                 value;
+  struct device_data* data = kobj_to_dev_data(kobj);
+
+  sscanf(buf, "%du", &value);
+
+  data->attr_frame_crc = (1 == value);
+
+  LOG_DEV(
+    debug, 
+    "frame CRC set to %s.\n", 
+    (data->attr_frame_crc ? "true" : "false")
+  );
+
+  return count;
+}
+
+ssize_t frameSTX_show(
+  struct kobject        *kobj, 
+  struct kobj_attribute *attr, 
+  char                  *buf
+)
+{
+  struct device_data* data = kobj_to_dev_data(kobj);
+
+  return sprintf(buf, "%u\n", data->attr_frame_stx);
+}
+
+ssize_t frameSTX_store(
+  struct kobject        *kobj, 
+  struct kobj_attribute *attr, 
+  const char            *buf, 
+  size_t                count
+)
+{
+  unsigned int        value;
+  struct device_data* data = kobj_to_dev_data(kobj);
+
+  sscanf(buf, "%udu", &value);
+
+  if (value > 0xFF)
+  {
+    LOG_DEV(err, "frame STX must be a byte value.\n");
+    return -EINVAL;
+  }
+
+  data->attr_frame_stx = value;
+
+  LOG_DEV(debug, "frame STX set to 0x%02X.\n", data->attr_frame_stx);
+  return count;
+}
+
+ssize_t frameETX_show(
+  struct kobject        *kobj, 
+  struct kobj_attribute *attr, 
+  char                  *buf
+)
+{
+  struct device_data* data = kobj_to_dev_data(kobj);
+
+  return sprintf(buf, "%u\n", data->attr_frame_etx);
+}
+
+ssize_t frameETX_store(
+  struct kobject        *kobj, 
+  struct kobj_attribute *attr, 
+  const char            *buf, 
+  size_t                count
+)
+{
+  unsigned int        value;
+  struct device_data* data = kobj_to_dev_data(kobj);
+
+  sscanf(buf, "%udu", &value);
+
+  if (value > 0xFF)
+  {
+    LOG_DEV(err, "frame ETX must be a byte value.\n");
+    return -EINVAL;
+  }
+
+  data->attr_frame_etx = value;
+
+  LOG_DEV(debug, "frame ETX set to 0x%02X.\n", data->attr_frame_etx);
+  return count;
+}
+
+ssize_t frameRepeatCount_show(
+  struct kobject        *kobj, 
+  struct kobj_attribute *attr, 
+  char                  *buf
+)
+{
+  struct device_data* data = kobj_to_dev_data(kobj);
+
+  return sprintf(buf, "%u\n", data->attr_repeat_count);
+}
+
+ssize_t frameRepeatCount_store(
+  struct kobject        *kobj, 
+  struct kobj_attribute *attr, 
+  const char            *buf, 
+  size_t                count
+)
+{
+  unsigned int        value;
+  struct device_data* data = kobj_to_dev_data(kobj);
+
+  sscanf(buf, "%udu", &value);
+
+  data->attr_repeat_count = value;
+
+  LOG_DEV(
+    debug, 
+    "frame repeat count set to %u times.\n", 
+    data->attr_repeat_count
+  );
+
+  return count;
+}
+
+ssize_t frameRepeatGap_show(
+  struct kobject        *kobj, 
+  struct kobj_attribute *attr, 
+  char                  *buf
+)
+{
+  struct device_data* data = kobj_to_dev_data(kobj);
+
+  return sprintf(buf, "%lu\n", data->attr_repeat_gap);
+}
+
+ssize_t frameRepeatGap_store(
+  struct kobject        *kobj, 
+  struct kobj_attribute *attr, 
+  const char            *buf, 
+  size_t                count
+)
+{
+  unsigned long       value;
+  struct device_data* data = kobj_to_dev_data(kobj);
+
+  sscanf(buf, "%luu", &value);
+
+  if (0 == value)
+  {
+    LOG_DEV(err, "frame repeat gap must be greater than zero.\n");
+    return -EINVAL;
+  }
+
+  if (value <= data->attr_sync_bit)
+  {
+    LOG_DEV(warn, "frame repeat gap should be greater than sync bit.\n");
+  }
+
+  data->attr_repeat_gap = value;
+
+  LOG_DEV(debug, "frame repeat gap set to %lu uS.\n", data->attr_repeat_gap);
+  return count;
+}
+
+ssize_t frameGap_show(
+  struct kobject        *kobj, 
+  struct kobj_attribute *attr, 
+  char                  *buf
+)
+{
+  struct device_data* data = kobj_to_dev_data(kobj);
+
+  return sprintf(buf, "%lu\n", data->attr_frame_gap);
+}
+
+ssize_t frameGap_store(
+  struct kobject        *kobj, 
+  struct kobj_attribute *attr, 
+  const char            *buf, 
+  size_t                count
+)
+{
+  unsigned long       value;
+  struct device_data* data = kobj_to_dev_data(kobj);
+
+  sscanf(buf, "%luu", &value);
+
+  if (0 == value)
+  {
+    LOG_DEV(err, "frame gap must be greater than zero.\n");
+    return -EINVAL;
+  }
+
+  if (value <= data->attr_sync_bit)
+  {
+    LOG_DEV(warn, "frame gap should be greater than sync bit.\n");
+  }
+
+  data->attr_frame_gap = value;
+
+  LOG_DEV(debug, "frame gap set to %lu uS.\n", data->attr_frame_gap);
+  return count;
+}
+
+ssize_t frameSync_show(
+  struct kobject        *kobj, 
+  struct kobj_attribute *attr, 
+  char                  *buf
+)
+{
+  struct device_data* data = kobj_to_dev_data(kobj);
+  
+  return sprintf(
+    buf, 
+    "%d\n", 
+    (data->attr_frame_sync ? 1 : 0)
+  );
+}
+
+ssize_t frameSync_store(
+  struct kobject        *kobj, 
+  struct kobj_attribute *attr, 
+  const char            *buf, 
+  size_t                count)
+{
+  int                 value;
+  struct device_data* data = kobj_to_dev_data(kobj);
+
+  sscanf(buf, "%du", &value);
+
+  data->attr_frame_sync = (1 == value);
+
+  LOG_DEV(
+    debug, 
+    "frame sync set to %s.\n", 
+    (data->attr_frame_sync ? "true" : "false")
+  );
+
+  return count;
+}
+
+ssize_t resyncInterval_show(
+  struct kobject        *kobj, 
+  struct kobj_attribute *attr, 
+  char                  *buf
+)
+{
+  struct device_data* data = kobj_to_dev_data(kobj);
+
+  return sprintf(buf, "%u\n", data->attr_resync_interval);
+}
+
+ssize_t resyncInterval_store(
+  struct kobject        *kobj, 
+  struct kobj_attribute *attr, 
+  const char            *buf, 
+  size_t                count
+)
+{
+  unsigned int        value;
+  struct device_data* data = kobj_to_dev_data(kobj);
+
+  sscanf(buf, "%udu", &value);
+
+  data->attr_resync_interval = value;
+
+  LOG_DEV(
+    debug, 
+    "resync interval set to %u byte(s).\n", 
+    data->attr_resync_interval
+  );
+
+  return count;
+}
+
+ssize_t multiLevel_show(
+  struct kobject        *kobj, 
+  struct kobj_attribute *attr, 
+  char                  *buf
+)
+{
+  struct device_data* data = kobj_to_dev_data(kobj);
+  
+  return sprintf(
+    buf, 
+    "%d\n", 
+    (data->attr_multi_level ? 1 : 0)
+  );
+}
+
+ssize_t multiLevel_store(
+  struct kobject        *kobj, 
+  struct kobj_attribute *attr, 
+  const char            *buf, 
+  size_t                count)
+{
+  int                 value;
+  struct device_data* data = kobj_to_dev_data(kobj);
+
+  sscanf(buf, "%du", &value);
+
+  data->attr_multi_level = (1 == value);
+
+  if (
+       data->attr_multi_level 
+    && (data->attr_sync_bit <= data->attr_three_symbol)
+  )
+  {
+    LOG_DEV(warn, "sync bit duration should be greater than symbol three.\n");
+  }
+
+  LOG_DEV(
+    debug, 
+    "multi level line code set to %s.\n", 
+    (data->attr_multi_level ? "true" : "false")
+  );
+
+  return count;
+}
+
+ssize_t symbolTwoDuration_show(
+  struct kobject        *kobj, 
+  struct kobj_attribute *attr, 
+  char                  *buf
+)
+{
+  struct device_data* data = kobj_to_dev_data(kobj);
+
+  return sprintf(buf, "%lu\n", data->attr_two_symbol);
+}
+
+ssize_t symbolTwoDuration_store(
+  struct kobject        *kobj, 
+  struct kobj_attribute *attr, 
+  const char            *buf, 
+  size_t                count
+)
+{
+  unsigned long       value;
+  struct device_data* data = kobj_to_dev_data(kobj);
+
+  sscanf(buf, "%luu", &value);
+
+  if (0 == value)
+  {
+    LOG_DEV(err, "symbol two duration must be greater than zero.\n");    
+    return -EINVAL;
+  }
+
+  if (value <= data->attr_one_bit)
+  {
+    LOG_DEV(warn, "symbol two duration should be greater than bit one.\n");
+  }
+
+  data->attr_two_symbol = value;
+
+  LOG_DEV(
+    debug, 
+    "symbol two duration set to %lu uS.\n", 
+    data->attr_two_symbol
+  );
+
+  return count;
+}
+
+ssize_t symbolThreeDuration_show(
+  struct kobject        *kobj, 
+  struct kobj_attribute *attr, 
+  char                  *buf
+)
+{
+  struct device_data* data = kobj_to_dev_data(kobj);
+
+  return sprintf(buf, "%lu\n", data->attr_three_symbol);
+}
+
+ssize_t symbolThreeDuration_store(
+  struct kobject        *kobj, 
+  struct kobj_attribute *attr, 
+  const char            *buf, 
+  size_t                count
+)
+{
+  unsigned long       value;
+  struct device_data* data = kobj_to_dev_data(kobj);
+
+  sscanf(buf, "%luu", &value);
+
+  if (0 == value)
+  {
+    LOG_DEV(err, "symbol three duration must be greater than zero.\n");    
+    return -EINVAL;
+  }
+
+  if (value <= data->attr_two_symbol)
+  {
+    LOG_DEV(warn, "symbol three duration should be greater than symbol two.\n");
+  }
+
+  data->attr_three_symbol = value;
+
+  LOG_DEV(
+    debug, 
+    "symbol three duration set to %lu uS.\n", 
+    data->attr_three_symbol
+  );
+
+  return count;
+}
\ No newline at end of file
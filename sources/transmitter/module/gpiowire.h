@@ -10,6 +10,7 @@
  * @see     http://www.romanblack.com/RF/cheapRFmodules.htm
 */
 
+#include <linux/crc-itu-t.h> // CRC-CCITT (0x1021, MSB first) for frame encoding
 #include <linux/device.h>  // Header to support the kernel Driver Model
 #include <linux/fs.h>      // Header for the Linux file system support
 #include <linux/gpio.h>    // Required for the GPIO functions
@@ -22,6 +23,8 @@
 #include <linux/mutex.h>   // Required for the mutex functionality
 #include <linux/slab.h>    // kmalloc / kfree
 #include <linux/uaccess.h> // Required for the copy to user function
+#include <linux/uio.h>     // iov_iter for vectored writes
+#include <linux/version.h> // LINUX_VERSION_CODE
 
 // Manifest
 
@@ -39,12 +42,28 @@ enum prot_edge
 	EDGE_HIGH = 1
 };
 
+enum prot_stage
+{
+  STAGE_STX      = 0,
+  STAGE_PAYLOAD  = 1,
+  STAGE_CRC_HIGH = 2,
+  STAGE_CRC_LOW  = 3,
+  STAGE_ETX      = 4,
+  STAGE_DONE     = 5
+};
+
 struct perf_data
 {
   enum prot_edge next_edge;
   ktime_t        time;
 };
 
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 4, 0)
+  #define GPIOWIRE_ITER_IOV(iter) iter_iov(iter)
+#else
+  #define GPIOWIRE_ITER_IOV(iter) ((iter)->iov)
+#endif
+
 struct prot_ctx
 {
   struct completion sem;
@@ -55,8 +74,27 @@ struct prot_ctx
 
   int               sync_count;
 
-  char              *message;
+  const size_t      *frame_lens;
+  size_t            frame_count;
+  size_t            frame_index;
+
+  const char        *msg_start;
+  size_t            msg_len;
+  int               repeat_count;
+
+  const char        *message;
   size_t            msg_count;
+
+  bool              frame_encoding;
+  bool              frame_crc;
+  bool              frame_sync;
+  bool              multi_level;
+  unsigned int      resync_interval;
+  size_t            byte_index;
+  enum prot_stage   stage;
+  u16               crc;
+
+  unsigned char     byte;
   int               bit_count;
   enum prot_edge    next_edge;
 };
@@ -83,12 +121,32 @@ struct device_data
   unsigned long attr_one_bit;
   unsigned long attr_sync_bit;
 
+  bool          attr_multi_level;
+  unsigned long attr_two_symbol;
+  unsigned long attr_three_symbol;
+
+  bool          attr_frame_encoding;
+  bool          attr_frame_crc;
+  unsigned char attr_frame_stx;
+  unsigned char attr_frame_etx;
+
+  unsigned int  attr_repeat_count;
+  unsigned long attr_repeat_gap;
+  unsigned long attr_frame_gap;
+
+  bool          attr_frame_sync;
+  unsigned int  attr_resync_interval;
+
   // Pre-calculated edges duration (for faster performances)
 
   ktime_t edge_high_state;
   ktime_t edge_zero_bit;
   ktime_t edge_one_bit;
+  ktime_t edge_two_symbol;
+  ktime_t edge_three_symbol;
   ktime_t edge_sync_bit;
+  ktime_t edge_repeat_gap;
+  ktime_t edge_frame_gap;
 
   // Protocol
 
@@ -215,6 +273,162 @@ ssize_t bitSyncDuration_store(
   size_t                count
 );
 
+ssize_t frameEncoding_show(
+  struct kobject        *kobj,
+  struct kobj_attribute *attr,
+  char                  *buf
+);
+
+ssize_t frameEncoding_store(
+  struct kobject        *kobj,
+  struct kobj_attribute *attr,
+  const char            *buf,
+  size_t                count
+);
+
+ssize_t frameCRC_show(
+  struct kobject        *kobj,
+  struct kobj_attribute *attr,
+  char                  *buf
+);
+
+ssize_t frameCRC_store(
+  struct kobject        *kobj,
+  struct kobj_attribute *attr,
+  const char            *buf,
+  size_t                count
+);
+
+ssize_t frameSTX_show(
+  struct kobject        *kobj,
+  struct kobj_attribute *attr,
+  char                  *buf
+);
+
+ssize_t frameSTX_store(
+  struct kobject        *kobj,
+  struct kobj_attribute *attr,
+  const char            *buf,
+  size_t                count
+);
+
+ssize_t frameETX_show(
+  struct kobject        *kobj,
+  struct kobj_attribute *attr,
+  char                  *buf
+);
+
+ssize_t frameETX_store(
+  struct kobject        *kobj,
+  struct kobj_attribute *attr,
+  const char            *buf,
+  size_t                count
+);
+
+ssize_t frameRepeatCount_show(
+  struct kobject        *kobj,
+  struct kobj_attribute *attr,
+  char                  *buf
+);
+
+ssize_t frameRepeatCount_store(
+  struct kobject        *kobj,
+  struct kobj_attribute *attr,
+  const char            *buf,
+  size_t                count
+);
+
+ssize_t frameRepeatGap_show(
+  struct kobject        *kobj,
+  struct kobj_attribute *attr,
+  char                  *buf
+);
+
+ssize_t frameRepeatGap_store(
+  struct kobject        *kobj,
+  struct kobj_attribute *attr,
+  const char            *buf,
+  size_t                count
+);
+
+ssize_t frameGap_show(
+  struct kobject        *kobj,
+  struct kobj_attribute *attr,
+  char                  *buf
+);
+
+ssize_t frameGap_store(
+  struct kobject        *kobj,
+  struct kobj_attribute *attr,
+  const char            *buf,
+  size_t                count
+);
+
+ssize_t frameSync_show(
+  struct kobject        *kobj,
+  struct kobj_attribute *attr,
+  char                  *buf
+);
+
+ssize_t frameSync_store(
+  struct kobject        *kobj,
+  struct kobj_attribute *attr,
+  const char            *buf,
+  size_t                count
+);
+
+ssize_t resyncInterval_show(
+  struct kobject        *kobj,
+  struct kobj_attribute *attr,
+  char                  *buf
+);
+
+ssize_t resyncInterval_store(
+  struct kobject        *kobj,
+  struct kobj_attribute *attr,
+  const char            *buf,
+  size_t                count
+);
+
+ssize_t multiLevel_show(
+  struct kobject        *kobj,
+  struct kobj_attribute *attr,
+  char                  *buf
+);
+
+ssize_t multiLevel_store(
+  struct kobject        *kobj,
+  struct kobj_attribute *attr,
+  const char            *buf,
+  size_t                count
+);
+
+ssize_t symbolTwoDuration_show(
+  struct kobject        *kobj,
+  struct kobj_attribute *attr,
+  char                  *buf
+);
+
+ssize_t symbolTwoDuration_store(
+  struct kobject        *kobj,
+  struct kobj_attribute *attr,
+  const char            *buf,
+  size_t                count
+);
+
+ssize_t symbolThreeDuration_show(
+  struct kobject        *kobj,
+  struct kobj_attribute *attr,
+  char                  *buf
+);
+
+ssize_t symbolThreeDuration_store(
+  struct kobject        *kobj,
+  struct kobj_attribute *attr,
+  const char            *buf,
+  size_t                count
+);
+
 bool       file_trylock(struct device_data* data);
 
 int        file_open(struct inode *inodep, struct file *filep);
@@ -227,10 +441,13 @@ ssize_t    file_write(
   loff_t            *offset
 );
 
+ssize_t    file_write_iter(struct kiocb *iocb, struct iov_iter *from);
+
 inline ssize_t prot_write_message(
   struct device_data *data,
   const char         *buffer,
-  size_t             len
+  const size_t       *frame_lens,
+  size_t             frame_count
 );
 
 
@@ -247,11 +464,12 @@ static int                    dev_count    = 0;
 
 static struct file_operations dev_file_ops =
 {
-   .owner   = THIS_MODULE,
+   .owner      = THIS_MODULE,
 
-   .open    = file_open,
-   .release = file_release,
-   .write   = file_write
+   .open       = file_open,
+   .release    = file_release,
+   .write      = file_write,
+   .write_iter = file_write_iter
 };
 
 static struct device_data def_dev_data =
@@ -266,7 +484,23 @@ static struct device_data def_dev_data =
   .attr_high_state     = 500,
   .attr_zero_bit       = 1000,
   .attr_one_bit        = 2000,
-  .attr_sync_bit       = 5000
+  .attr_sync_bit       = 5000,
+
+  .attr_multi_level    = false,
+  .attr_two_symbol     = 2500,
+  .attr_three_symbol   = 3000,
+
+  .attr_frame_encoding = false,
+  .attr_frame_crc      = false,
+  .attr_frame_stx      = 0x02,
+  .attr_frame_etx      = 0x03,
+
+  .attr_repeat_count   = 0,
+  .attr_repeat_gap     = 20000,
+  .attr_frame_gap      = 20000,
+
+  .attr_frame_sync      = false,
+  .attr_resync_interval = 0
 };
 
 // Debug macros
@@ -297,6 +531,18 @@ DEFINE_ATTRIBUTE(bitZeroDuration);
 DEFINE_ATTRIBUTE(bitOneDuration);
 DEFINE_ATTRIBUTE(bitSyncDuration);
 DEFINE_ATTRIBUTE(bitSyncCount);
+DEFINE_ATTRIBUTE(frameEncoding);
+DEFINE_ATTRIBUTE(frameCRC);
+DEFINE_ATTRIBUTE(frameSTX);
+DEFINE_ATTRIBUTE(frameETX);
+DEFINE_ATTRIBUTE(frameRepeatCount);
+DEFINE_ATTRIBUTE(frameRepeatGap);
+DEFINE_ATTRIBUTE(frameGap);
+DEFINE_ATTRIBUTE(frameSync);
+DEFINE_ATTRIBUTE(resyncInterval);
+DEFINE_ATTRIBUTE(multiLevel);
+DEFINE_ATTRIBUTE(symbolTwoDuration);
+DEFINE_ATTRIBUTE(symbolThreeDuration);
 
 struct attribute *dev_attrs[] = {
   &perfDebug_attr.attr,
@@ -308,6 +554,18 @@ struct attribute *dev_attrs[] = {
   &bitOneDuration_attr.attr,
   &bitSyncDuration_attr.attr,
   &bitSyncCount_attr.attr,
+  &frameEncoding_attr.attr,
+  &frameCRC_attr.attr,
+  &frameSTX_attr.attr,
+  &frameETX_attr.attr,
+  &frameRepeatCount_attr.attr,
+  &frameRepeatGap_attr.attr,
+  &frameGap_attr.attr,
+  &frameSync_attr.attr,
+  &resyncInterval_attr.attr,
+  &multiLevel_attr.attr,
+  &symbolTwoDuration_attr.attr,
+  &symbolThreeDuration_attr.attr,
   NULL
 };
 
@@ -22,6 +22,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <string.h>
 
 #include "GPIOWire.hpp"
+#include "GPIOWireLine.hpp"
+#include "StaticMessage.hpp"
 
 #define GPIO_PIN_NUMBER        133
 #define GPIO_CAN_SLEEP         false
@@ -34,6 +36,27 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define GPIO_BIT_SYNC_DURATION 2500
 
 #define GPIO_CRC               true
+#define GPIO_FEC               false
+#define GPIO_COMPRESSION       false
+#define GPIO_LENGTH_PREFIX     false
+#define GPIO_ADDRESSING        false
+#define GPIO_DESTINATION       '\x01'
+#define GPIO_KERNEL_FRAMING    false
+#define GPIO_STATIC_MESSAGE    false
+
+#define GPIO_REPEAT_COUNT      0
+#define GPIO_REPEAT_GAP        20000
+
+#define GPIO_FRAME_SYNC        false
+#define GPIO_RESYNC_INTERVAL   0
+
+#define GPIO_MULTI_LEVEL       false
+#define GPIO_SYMBOL_TWO        2000
+#define GPIO_SYMBOL_THREE      2250
+
+#define GPIO_USERSPACE         false
+#define GPIO_CHIP              "/dev/gpiochip0"
+#define GPIO_LINE_OFFSET       133
 
 void Test_GPIOWire()
 {
@@ -41,28 +64,122 @@ void Test_GPIOWire()
 
   CGPIOWire GPIOWire(0);
 
+  if (GPIO_USERSPACE)
+  {
+    // No kernel module: the same line code is played through the GPIO
+    // character device.
+
+    SGPIOWireLineCode LineCode;
+
+    LineCode.ulSyncBitCount        = GPIO_SYNC_BIT_COUNT;
+    LineCode.ulHighStateEdge       = GPIO_HIGH_STATE_EDGE;
+    LineCode.ulBitZeroDuration     = GPIO_BIT_ZERO_DURATION;
+    LineCode.ulBitOneDuration      = GPIO_BIT_ONE_DURATION;
+    LineCode.ulBitSyncDuration     = GPIO_BIT_SYNC_DURATION;
+    LineCode.bFrameSync            = GPIO_FRAME_SYNC;
+    LineCode.ulResyncInterval      = GPIO_RESYNC_INTERVAL;
+    LineCode.bMultiLevel           = GPIO_MULTI_LEVEL;
+    LineCode.ulSymbolTwoDuration   = GPIO_SYMBOL_TWO;
+    LineCode.ulSymbolThreeDuration = GPIO_SYMBOL_THREE;
+    LineCode.ulRepeatCount         = GPIO_REPEAT_COUNT;
+    LineCode.ulRepeatGap           = GPIO_REPEAT_GAP;
+
+    GPIOWire.SetLineCode(LineCode);
+    GPIOWire.SetFEC(GPIO_FEC);
+    GPIOWire.SetCompression(GPIO_COMPRESSION);
+    GPIOWire.SetLengthPrefix(GPIO_LENGTH_PREFIX);
+    GPIOWire.SetDestination(GPIO_ADDRESSING, GPIO_DESTINATION);
+
+    CGPIOWireLine Line(
+      GPIO_CHIP,
+      GPIO_LINE_OFFSET,
+      GPIOWire.GetLineCode(),
+      GPIO_SWAP_OUTPUT
+    );
+
+    size_t          nSize  = GPIOWire.CreateArenaMessage(MESSAGE, GPIO_CRC);
+    SGPIOWireResult Result = Line.GetLastResult();
+
+    if (Result && nSize)
+    {
+      Result = Line.SendMessage(GPIOWire.GetArenaMessage(), nSize);
+    }
+
+    if (!Result)
+    {
+      fprintf(stderr, "%s\n", Result.GetDescription().c_str());
+    }
+
+    return;
+  }
+
   if (GPIOWire.Exists())
   {
-    if (GPIOWire.Configure(
-      GPIO_PIN_NUMBER,
-      GPIO_CAN_SLEEP,
-      GPIO_SWAP_OUTPUT,
-      GPIO_SYNC_BIT_COUNT,
-      GPIO_HIGH_STATE_EDGE,
-      GPIO_BIT_ZERO_DURATION,
-      GPIO_BIT_ONE_DURATION,
-      GPIO_BIT_SYNC_DURATION
-    ))
+    if (
+         GPIOWire.Configure(
+           GPIO_PIN_NUMBER,
+           GPIO_CAN_SLEEP,
+           GPIO_SWAP_OUTPUT,
+           GPIO_SYNC_BIT_COUNT,
+           GPIO_HIGH_STATE_EDGE,
+           GPIO_BIT_ZERO_DURATION,
+           GPIO_BIT_ONE_DURATION,
+           GPIO_BIT_SYNC_DURATION
+         )
+      && GPIOWire.ConfigureFraming(GPIO_KERNEL_FRAMING, GPIO_CRC)
+      && GPIOWire.ConfigureRepetition(GPIO_REPEAT_COUNT, GPIO_REPEAT_GAP)
+      && GPIOWire.ConfigureFrameSync(GPIO_FRAME_SYNC, GPIO_RESYNC_INTERVAL)
+      && GPIOWire.ConfigureMultiLevel(
+           GPIO_MULTI_LEVEL,
+           GPIO_SYMBOL_TWO,
+           GPIO_SYMBOL_THREE
+         )
+    )
     {
-      size_t         nSize     = strlen(MESSAGE);
-      unsigned char* lpMessage = GPIOWire.CreateMessage(
-        MESSAGE,
-        nSize,
-        GPIO_CRC 
-      );
-
-      GPIOWire.SendMessage(lpMessage, nSize);
-      CGPIOWire::FreeMessage(lpMessage);
+      if (GPIO_KERNEL_FRAMING)
+      {
+        // Framing and CRC are computed by the module while transmitting.
+
+        GPIOWire.SendMessage(
+          (const unsigned char *)MESSAGE,
+          strlen(MESSAGE)
+        );
+
+        return;
+      }
+
+      if (GPIO_STATIC_MESSAGE)
+      {
+        // Frame built at compile time (no FEC, compression, etc.).
+
+        static constexpr auto lpStaticMessage =
+          CreateStaticMessage<GPIO_CRC>(MESSAGE);
+
+        GPIOWire.SendMessage(lpStaticMessage.data(), lpStaticMessage.size());
+
+        return;
+      }
+
+      GPIOWire.SetFEC(GPIO_FEC);
+      GPIOWire.SetCompression(GPIO_COMPRESSION);
+      GPIOWire.SetLengthPrefix(GPIO_LENGTH_PREFIX);
+      GPIOWire.SetDestination(GPIO_ADDRESSING, GPIO_DESTINATION);
+
+      CGPIOWireSession Session = GPIOWire.OpenSession();
+      size_t           nSize   = GPIOWire.CreateArenaMessage(MESSAGE, GPIO_CRC);
+
+      if (nSize)
+      {
+        SGPIOWireResult Result = Session.SendMessage(
+          GPIOWire.GetArenaMessage(),
+          nSize
+        );
+
+        if (!Result)
+        {
+          fprintf(stderr, "%s\n", Result.GetDescription().c_str());
+        }
+      }
     }
   }
 }
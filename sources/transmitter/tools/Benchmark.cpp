@@ -0,0 +1,70 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "Benchmark.hpp"
+
+struct SBenchmark
+{
+  const char* lpszName;
+  const char* lpszUsage;
+  int         (*lpfnRun)(int argc, char *argv[]);
+};
+
+static const SBenchmark m_lpBenchmarks[] =
+{
+  { "batch",       "[record size] [record count]",                            Benchmark_Batch       },
+  { "compression", "<corpus>",                                                Benchmark_Compression },
+  { "coroutine",   "[device] [senders] [frames/sender]",                      Benchmark_Coroutine   },
+  { "crc16",       "",                                                        Benchmark_CRC16       },
+  { "jitter",      "<chip> <line> [frames] [loop chip] [loop line] [device]", Benchmark_Jitter      }
+};
+
+#define BENCHMARK_COUNT (sizeof(m_lpBenchmarks) / sizeof(m_lpBenchmarks[0]))
+
+int main(int argc, char *argv[])
+{
+  if (argc > 1)
+  {
+    for (size_t nIndex = 0; nIndex < BENCHMARK_COUNT; nIndex++)
+    {
+      if (0 == strcmp(argv[1], m_lpBenchmarks[nIndex].lpszName))
+      {
+        return m_lpBenchmarks[nIndex].lpfnRun((argc - 1), (argv + 1));
+      }
+    }
+  }
+
+  fprintf(stderr, "Usage: %s <benchmark> [arguments]\n\n", argv[0]);
+
+  for (size_t nIndex = 0; nIndex < BENCHMARK_COUNT; nIndex++)
+  {
+    fprintf(
+      stderr,
+      "  %s %s\n",
+      m_lpBenchmarks[nIndex].lpszName,
+      m_lpBenchmarks[nIndex].lpszUsage
+    );
+  }
+
+  return 1;
+}
@@ -0,0 +1,48 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef _BENCHMARK_HPP_
+#define _BENCHMARK_HPP_
+
+#include <stdint.h>
+#include <time.h>
+
+using namespace std;
+
+// Benchmarks entry points (argv[0] is the benchmark name)
+
+int Benchmark_Batch(int argc, char *argv[]);
+int Benchmark_Compression(int argc, char *argv[]);
+int Benchmark_Coroutine(int argc, char *argv[]);
+int Benchmark_CRC16(int argc, char *argv[]);
+int Benchmark_Jitter(int argc, char *argv[]);
+
+// Helpers
+
+inline uint64_t GetTimeNs()
+{
+  struct timespec Time;
+
+  clock_gettime(CLOCK_MONOTONIC, &Time);
+
+  return ((uint64_t)Time.tv_sec * 1000000000ULL) + Time.tv_nsec;
+}
+
+#endif /* _BENCHMARK_HPP_ */
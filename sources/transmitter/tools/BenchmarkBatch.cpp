@@ -0,0 +1,156 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "GPIOWire.hpp"
+
+// On air figures come from the line code model (CGPIOWire::GetAirTime()) plus
+// the kernel module default inter-frame gap, so no device is needed.
+
+#define BATCH_FRAME_GAP   20000
+#define BATCH_MAX_PAYLOAD 56    // Fits the receiver DECODER_BUFFER_SIZE
+
+struct SBatchResult
+{
+  size_t   nFrames;
+  size_t   nBytes;
+  uint64_t nAirTime;
+  uint64_t nCPUTime;
+};
+
+static void PrintBatchResult(
+  const char*         lpszName,
+  const SBatchResult& Result,
+  size_t              nRecords
+)
+{
+  double dSeconds = ((double)Result.nAirTime / 1000000.0);
+
+  printf("%s\n", lpszName);
+  printf("  Frames           : %zu\n", Result.nFrames);
+  printf("  Bytes on air     : %zu\n", Result.nBytes);
+  printf("  Air time         : %.3f s\n", dSeconds);
+  printf("  Frames/s         : %.2f\n", (Result.nFrames / dSeconds));
+  printf("  Records/s        : %.2f\n", (nRecords / dSeconds));
+  printf(
+    "  Encode           : %.1f ns/record\n",
+    ((double)Result.nCPUTime / nRecords)
+  );
+}
+
+int Benchmark_Batch(int argc, char *argv[])
+{
+  size_t nRecordSize  = ((argc > 1) ? atoi(argv[1]) : 6);
+  size_t nRecordCount = ((argc > 2) ? atoi(argv[2]) : 1000);
+
+  if ((nRecordSize < 1) || ((2 + nRecordSize) > BATCH_MAX_PAYLOAD))
+  {
+    fprintf(stderr, "Invalid record size (1-%d).\n", (BATCH_MAX_PAYLOAD - 2));
+    return 1;
+  }
+
+  // Binary payloads (record index) need a binary safe frame format
+
+  CGPIOWire GPIOWire(0);
+
+  GPIOWire.SetLengthPrefix(true);
+  GPIOWire.ConfigureBatch(BATCH_MAX_PAYLOAD, ULONG_MAX, true);
+
+  vector<unsigned char> lpRecords(nRecordSize * nRecordCount);
+
+  for (size_t nIndex = 0; nIndex < lpRecords.size(); nIndex++)
+  {
+    lpRecords[nIndex] = (unsigned char)rand();
+  }
+
+  // One frame per record
+
+  SBatchResult Single = { 0, 0, 0, 0 };
+
+  for (size_t nIndex = 0; nIndex < nRecordCount; nIndex++)
+  {
+    size_t   nSize  = nRecordSize;
+    uint64_t nStart = GetTimeNs();
+
+    unsigned char* lpMessage = GPIOWire.CreateMessage(
+      (const char *)&lpRecords[nIndex * nRecordSize],
+      nSize,
+      true
+    );
+
+    Single.nCPUTime += (GetTimeNs() - nStart);
+    Single.nFrames++;
+    Single.nBytes   += nSize;
+    Single.nAirTime += (GPIOWire.GetAirTime(lpMessage, nSize) + BATCH_FRAME_GAP);
+
+    CGPIOWire::FreeMessage(lpMessage);
+  }
+
+  // Batched records (as many as fit a frame)
+
+  SBatchResult Batch          = { 0, 0, 0, 0 };
+  size_t       nFrameCapacity = ((BATCH_MAX_PAYLOAD - 1) / (1 + nRecordSize));
+
+  for (size_t nIndex = 0; nIndex < nRecordCount; nIndex++)
+  {
+    uint64_t nStart = GetTimeNs();
+
+    GPIOWire.AddRecord(&lpRecords[nIndex * nRecordSize], nRecordSize);
+
+    if (
+         (GPIOWire.GetBatchRecordCount() < nFrameCapacity)
+      && (nIndex < (nRecordCount - 1))
+    )
+    {
+      Batch.nCPUTime += (GetTimeNs() - nStart);
+      continue;
+    }
+
+    size_t         nSize     = 0;
+    unsigned char* lpMessage = GPIOWire.CreateBatchMessage(nSize);
+
+    Batch.nCPUTime += (GetTimeNs() - nStart);
+    Batch.nFrames++;
+    Batch.nBytes   += nSize;
+    Batch.nAirTime += (GPIOWire.GetAirTime(lpMessage, nSize) + BATCH_FRAME_GAP);
+
+    CGPIOWire::FreeMessage(lpMessage);
+  }
+
+  printf("Records          : %zu x %zu bytes\n", nRecordCount, nRecordSize);
+  printf("Records/frame    : %zu\n\n", nFrameCapacity);
+
+  PrintBatchResult("Single record frames", Single, nRecordCount);
+  printf("\n");
+  PrintBatchResult("Batched frames", Batch, nRecordCount);
+
+  printf(
+    "\nSpeedup          : %.2fx records/s\n",
+    ((double)Single.nAirTime / Batch.nAirTime)
+  );
+
+  return 0;
+}
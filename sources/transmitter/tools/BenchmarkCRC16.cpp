@@ -0,0 +1,148 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "Utils.hpp"
+
+#define CRC16_VERIFY_MAX_SIZE 4096
+#define CRC16_BYTES_PER_SIZE  (32 * 1024 * 1024)
+
+typedef uint16_t (*CRC16Function)(const unsigned char*, size_t, uint16_t);
+
+struct SCRC16Implementation
+{
+  const char*   lpszName;
+  CRC16Function lpfnCRC16;
+};
+
+int Benchmark_CRC16(int argc, char *argv[])
+{
+  vector<SCRC16Implementation> lpImplementations = {
+    { "bitwise",  CUtils::CRC16Bitwise },
+    { "table",    CUtils::CRC16Table   },
+    { "slice-8",  CUtils::CRC16Slice8  }
+  };
+
+  if (CUtils::HasCRC16CLMul())
+  {
+    lpImplementations.push_back({ "clmul", CUtils::CRC16CLMul });
+  }
+
+  lpImplementations.push_back({ "selected", CUtils::CRC16 });
+
+  vector<unsigned char> lpData(8 * 1024 * 1024 + 16);
+
+  for (size_t nIndex = 0; nIndex < lpData.size(); nIndex++)
+  {
+    lpData[nIndex] = (unsigned char)rand();
+  }
+
+  // Bit exact verification against the bitwise routine (every size, random
+  // alignment and initial value)
+
+  for (size_t nSize = 0; nSize <= CRC16_VERIFY_MAX_SIZE; nSize++)
+  {
+    const unsigned char* lpBuffer  = (lpData.data() + (rand() % 16));
+    uint16_t             nInitial  = (uint16_t)rand();
+    uint16_t             nExpected = CUtils::CRC16Bitwise(lpBuffer, nSize, nInitial);
+
+    for (size_t nIndex = 1; nIndex < lpImplementations.size(); nIndex++)
+    {
+      uint16_t nCRC = lpImplementations[nIndex].lpfnCRC16(
+        lpBuffer,
+        nSize,
+        nInitial
+      );
+
+      if (nCRC != nExpected)
+      {
+        fprintf(
+          stderr,
+          "%s mismatch (size %zu, 0x%04X instead of 0x%04X).\n",
+          lpImplementations[nIndex].lpszName,
+          nSize,
+          nCRC,
+          nExpected
+        );
+
+        return 1;
+      }
+    }
+  }
+
+  if (
+       CUtils::CRC16Bitwise(lpData.data(), lpData.size())
+    != CUtils::CRC16(lpData.data(), lpData.size())
+  )
+  {
+    fprintf(stderr, "Mismatch on the whole buffer.\n");
+    return 1;
+  }
+
+  printf("Verified sizes 0-%d bytes: OK\n\n", CRC16_VERIFY_MAX_SIZE);
+
+  // Throughput
+
+  printf("%10s", "Size");
+
+  for (size_t nIndex = 0; nIndex < lpImplementations.size(); nIndex++)
+  {
+    printf(" %10s", lpImplementations[nIndex].lpszName);
+  }
+
+  printf("   (MB/s)\n");
+
+  for (size_t nSize = 8; nSize <= (lpData.size() - 16); nSize *= 8)
+  {
+    printf("%10zu", nSize);
+
+    for (size_t nIndex = 0; nIndex < lpImplementations.size(); nIndex++)
+    {
+      size_t   nRounds = max((size_t)1, (CRC16_BYTES_PER_SIZE / nSize));
+      uint16_t nCRC    = 0;
+      uint64_t nStart  = GetTimeNs();
+
+      for (size_t nRound = 0; nRound < nRounds; nRound++)
+      {
+        nCRC ^= lpImplementations[nIndex].lpfnCRC16(lpData.data(), nSize, nCRC);
+      }
+
+      uint64_t nTime = (GetTimeNs() - nStart);
+
+      // Keep the result alive
+
+      if (nCRC == 0x1234)
+      {
+        printf(" ");
+      }
+
+      printf(" %10.1f", ((nSize * nRounds * 1000.0) / nTime));
+    }
+
+    printf("\n");
+  }
+
+  return 0;
+}
@@ -0,0 +1,135 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "Compression.hpp"
+
+#define COMPRESSION_ROUNDS 1000
+
+int Benchmark_Compression(int argc, char *argv[])
+{
+  if (argc < 2)
+  {
+    fprintf(stderr, "Missing corpus file.\n");
+    return 1;
+  }
+
+  ifstream       Corpus(argv[1]);
+  vector<string> lpMessages;
+  string         sLine;
+
+  while (getline(Corpus, sLine))
+  {
+    if (!sLine.empty())
+    {
+      lpMessages.push_back(sLine);
+    }
+  }
+
+  if (lpMessages.empty())
+  {
+    fprintf(stderr, "Empty or missing corpus \"%s\".\n", argv[1]);
+    return 1;
+  }
+
+  size_t   nRawSize        = 0;
+  size_t   nCompressedSize = 0;
+  uint64_t nEncodeTime     = 0;
+  uint64_t nDecodeTime     = 0;
+
+  vector<unsigned char> lpCompressed;
+  vector<unsigned char> lpDecompressed;
+
+  for (size_t nIndex = 0; nIndex < lpMessages.size(); nIndex++)
+  {
+    const string& sMessage = lpMessages[nIndex];
+    size_t        nSize    = 0;
+    size_t        nOutSize = 0;
+
+    lpCompressed.resize(CCompression::GetMaxCompressedSize(sMessage.length()));
+    lpDecompressed.resize(sMessage.length());
+
+    uint64_t nStart = GetTimeNs();
+
+    for (int iRound = 0; iRound < COMPRESSION_ROUNDS; iRound++)
+    {
+      nSize = CCompression::Compress(
+        (const unsigned char *)sMessage.data(),
+        sMessage.length(),
+        lpCompressed.data()
+      );
+    }
+
+    nEncodeTime += (GetTimeNs() - nStart);
+    nStart       = GetTimeNs();
+
+    for (int iRound = 0; iRound < COMPRESSION_ROUNDS; iRound++)
+    {
+      nOutSize = CCompression::Decompress(
+        lpCompressed.data(),
+        nSize,
+        lpDecompressed.data(),
+        lpDecompressed.size()
+      );
+    }
+
+    nDecodeTime += (GetTimeNs() - nStart);
+
+    if (
+         (nOutSize != sMessage.length())
+      || (0 != memcmp(lpDecompressed.data(), sMessage.data(), nOutSize))
+    )
+    {
+      fprintf(stderr, "Round trip failed for \"%s\".\n", sMessage.c_str());
+      return 1;
+    }
+
+    nRawSize        += sMessage.length();
+    nCompressedSize += nSize;
+  }
+
+  printf("Messages         : %zu\n", lpMessages.size());
+  printf("Raw bytes        : %zu\n", nRawSize);
+  printf("Compressed bytes : %zu\n", nCompressedSize);
+  printf(
+    "Ratio            : %.3f (%.1f%% airtime saved)\n",
+    ((double)nCompressedSize / nRawSize),
+    (100.0 * (1.0 - ((double)nCompressedSize / nRawSize)))
+  );
+  printf(
+    "Encode           : %.1f ns/message, %.1f MB/s\n",
+    ((double)nEncodeTime / (lpMessages.size() * COMPRESSION_ROUNDS)),
+    ((nRawSize * COMPRESSION_ROUNDS * 1000.0) / nEncodeTime)
+  );
+  printf(
+    "Decode           : %.1f ns/message, %.1f MB/s\n",
+    ((double)nDecodeTime / (lpMessages.size() * COMPRESSION_ROUNDS)),
+    ((nRawSize * COMPRESSION_ROUNDS * 1000.0) / nDecodeTime)
+  );
+
+  return 0;
+}
@@ -0,0 +1,181 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "GPIOWire.hpp"
+#include "GPIOWireCoroutine.hpp"
+
+// Many logical senders, each one sending its frames one at a time, either as
+// a thread blocked on CGPIOWireSession or as a coroutine awaiting
+// CGPIOWireAsync on a single executor. With /dev/null the figures show the
+// per frame overhead, a real device adds its air time.
+
+#define COROUTINE_MESSAGE "Hello from GPIO wire!"
+
+struct SCoroutineResult
+{
+  uint64_t nWallTime;
+  size_t   nFrames;
+  size_t   nErrors;
+  size_t   nThreads;
+};
+
+static void PrintCoroutineResult(
+  const char*             lpszName,
+  const SCoroutineResult& Result
+)
+{
+  double dSeconds = ((double)Result.nWallTime / 1000000000.0);
+
+  printf("%s\n", lpszName);
+  printf("  Threads          : %zu\n", Result.nThreads);
+  printf("  Frames           : %zu (%zu errors)\n", Result.nFrames, Result.nErrors);
+  printf("  Wall time        : %.3f s\n", dSeconds);
+  printf("  Frames/s         : %.2f\n", (Result.nFrames / dSeconds));
+  printf(
+    "  Per frame        : %.1f ns\n",
+    ((double)Result.nWallTime / Result.nFrames)
+  );
+}
+
+static CGPIOWireTask SendFrames(
+  CGPIOWireAsync&      Wire,
+  const unsigned char* lpMessage,
+  size_t               nSize,
+  size_t               nFrames,
+  size_t&              nErrors
+)
+{
+  for (size_t nIndex = 0; nIndex < nFrames; nIndex++)
+  {
+    SGPIOWireSendReport Report = co_await Wire.Send(lpMessage, nSize);
+
+    if (!Report.Result)
+    {
+      nErrors++;
+    }
+  }
+}
+
+int Benchmark_Coroutine(int argc, char *argv[])
+{
+  string sDevice  = ((argc > 1) ? argv[1] : "/dev/null");
+  size_t nSenders = ((argc > 2) ? atoi(argv[2]) : 1000);
+  size_t nFrames  = ((argc > 3) ? atoi(argv[3]) : 100);
+
+  if ((nSenders < 1) || (nFrames < 1))
+  {
+    fprintf(stderr, "Invalid sender or frame count.\n");
+    return 1;
+  }
+
+  CGPIOWire GPIOWire(0);
+  size_t    nSize = GPIOWire.CreateArenaMessage(COROUTINE_MESSAGE, true);
+
+  const unsigned char* lpMessage = GPIOWire.GetArenaMessage();
+
+  // One blocked thread per sender
+
+  SCoroutineResult Blocking = { 0, (nSenders * nFrames), 0, nSenders };
+
+  {
+    CGPIOWireSession Session(sDevice);
+
+    if (!Session.IsOpen())
+    {
+      fprintf(stderr, "%s\n", Session.GetLastResult().GetDescription().c_str());
+      return 1;
+    }
+
+    // Sessions are not thread safe (nor is the device shared by writers)
+
+    mutex          SessionMutex;
+    vector<thread> lpThreads;
+    vector<size_t> lpErrors(nSenders, 0);
+    uint64_t       nStart = GetTimeNs();
+
+    for (size_t nSender = 0; nSender < nSenders; nSender++)
+    {
+      lpThreads.emplace_back(
+        [&, nSender]()
+        {
+          for (size_t nIndex = 0; nIndex < nFrames; nIndex++)
+          {
+            lock_guard<mutex> Lock(SessionMutex);
+
+            if (!Session.SendMessage(lpMessage, nSize))
+            {
+              lpErrors[nSender]++;
+            }
+          }
+        }
+      );
+    }
+
+    for (size_t nSender = 0; nSender < nSenders; nSender++)
+    {
+      lpThreads[nSender].join();
+      Blocking.nErrors += lpErrors[nSender];
+    }
+
+    Blocking.nWallTime = (GetTimeNs() - nStart);
+  }
+
+  // One coroutine per sender, a single executor thread plus the writer one
+
+  SCoroutineResult Coroutine = { 0, (nSenders * nFrames), 0, 2 };
+
+  {
+    CGPIOWireExecutor Executor;
+    uint64_t          nStart = GetTimeNs();
+
+    {
+      CGPIOWireAsync Wire(Executor, CGPIOWireSession(sDevice), nSenders);
+
+      for (size_t nSender = 0; nSender < nSenders; nSender++)
+      {
+        Executor.Spawn(
+          SendFrames(Wire, lpMessage, nSize, nFrames, Coroutine.nErrors)
+        );
+      }
+
+      Executor.Run();
+    }
+
+    Coroutine.nWallTime = (GetTimeNs() - nStart);
+  }
+
+  printf("Device           : %s\n", sDevice.c_str());
+  printf("Senders          : %zu x %zu frames\n\n", nSenders, nFrames);
+
+  PrintCoroutineResult("Blocking sessions", Blocking);
+  printf("\n");
+  PrintCoroutineResult("Coroutines", Coroutine);
+
+  return 0;
+}
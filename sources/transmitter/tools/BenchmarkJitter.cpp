@@ -0,0 +1,383 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "GPIOWire.hpp"
+#include "GPIOWireLine.hpp"
+
+// Edge timing of the userspace transmitter (CGPIOWireLine), sleeping or
+// spinning before each edge, and of the kernel module on the same board.
+// The userspace lateness is self measured (gpio-sim or gpio-mockup are
+// enough); with the output wired back to an input line, the edges are also
+// timestamped by the kernel (uAPI edge events) and the pulse widths are
+// compared with the schedule, for both transmitters.
+
+#define JITTER_PAYLOAD_SIZE 8
+#define JITTER_SPIN_TIME    50 // uS
+#define JITTER_EVENTS       64
+
+class CEdgeCapture
+{
+public:
+  CEdgeCapture(const string& sChip, unsigned int uiOffset)
+    : m_iLine(-1)
+    , m_bStop(false)
+  {
+    int iChip = open(sChip.c_str(), (O_RDWR | O_CLOEXEC));
+
+    if (-1 == iChip)
+    {
+      return;
+    }
+
+    struct gpio_v2_line_request Request;
+
+    memset(&Request, 0, sizeof(Request));
+
+    Request.offsets[0]        = uiOffset;
+    Request.num_lines         = 1;
+    Request.event_buffer_size = 1024;
+    Request.config.flags      = (
+        GPIO_V2_LINE_FLAG_INPUT
+      | GPIO_V2_LINE_FLAG_EDGE_RISING
+      | GPIO_V2_LINE_FLAG_EDGE_FALLING
+    );
+
+    strncpy(Request.consumer, "gpiowire-capture", (sizeof(Request.consumer) - 1));
+
+    if (-1 != ioctl(iChip, GPIO_V2_GET_LINE_IOCTL, &Request))
+    {
+      m_iLine = Request.fd;
+    }
+
+    close(iChip);
+  }
+
+  ~CEdgeCapture()
+  {
+    if (-1 != m_iLine)
+    {
+      close(m_iLine);
+    }
+  }
+
+  bool IsOpen() const
+  {
+    return (-1 != m_iLine);
+  }
+
+  void Start()
+  {
+    m_lpTimes.clear();
+    m_bStop.store(false);
+
+    m_Reader = thread(&CEdgeCapture::Run, this);
+  }
+
+  // Edge timestamps (nS, monotonic).
+
+  const vector<uint64_t>& Stop()
+  {
+    // Let the last edges in
+
+    usleep(100000);
+
+    m_bStop.store(true);
+    m_Reader.join();
+
+    return m_lpTimes;
+  }
+
+private:
+  int              m_iLine;
+  atomic<bool>     m_bStop;
+  vector<uint64_t> m_lpTimes;
+  thread           m_Reader;
+
+  void Run()
+  {
+    struct gpio_v2_line_event lpEvents[JITTER_EVENTS];
+    struct pollfd             Poll = { m_iLine, POLLIN, 0 };
+
+    while (!m_bStop.load())
+    {
+      if (poll(&Poll, 1, 10) <= 0)
+      {
+        continue;
+      }
+
+      ssize_t nRead = read(m_iLine, lpEvents, sizeof(lpEvents));
+
+      for (ssize_t nIndex = 0; nIndex < (nRead / (ssize_t)sizeof(lpEvents[0])); nIndex++)
+      {
+        m_lpTimes.push_back(lpEvents[nIndex].timestamp_ns);
+      }
+    }
+  }
+};
+
+static SGPIOWireJitter GetStatistics(vector<uint64_t>& lpValues)
+{
+  SGPIOWireJitter Jitter = { lpValues.size(), 0, 0, 0 };
+
+  if (lpValues.empty())
+  {
+    return Jitter;
+  }
+
+  uint64_t ulTotal = 0;
+
+  for (size_t nIndex = 0; nIndex < lpValues.size(); nIndex++)
+  {
+    ulTotal      += lpValues[nIndex];
+    Jitter.ulMax  = max(Jitter.ulMax, lpValues[nIndex]);
+  }
+
+  size_t nP99 = ((lpValues.size() * 99) / 100);
+
+  nth_element(lpValues.begin(), (lpValues.begin() + nP99), lpValues.end());
+
+  Jitter.ulMean = (ulTotal / lpValues.size());
+  Jitter.ulP99  = lpValues[nP99];
+
+  return Jitter;
+}
+
+static void PrintJitter(const char* lpszName, const SGPIOWireJitter& Jitter)
+{
+  printf("  %s\n", lpszName);
+  printf("    Edges          : %zu\n", Jitter.nEdges);
+  printf("    Mean           : %.1f uS\n", (Jitter.ulMean / 1000.0));
+  printf("    P99            : %.1f uS\n", (Jitter.ulP99 / 1000.0));
+  printf("    Max            : %.1f uS\n", (Jitter.ulMax / 1000.0));
+}
+
+static void PrintPulseError(
+  const vector<uint64_t>& lpEdges,
+  const vector<uint32_t>& lpSchedule
+)
+{
+  // The lead in is not an edge: the first one is the first rising edge
+
+  if (lpEdges.size() != lpSchedule.size())
+  {
+    printf(
+      "  Captured edges   : %zu of %zu (check the loopback wiring)\n",
+      lpEdges.size(),
+      lpSchedule.size()
+    );
+
+    return;
+  }
+
+  vector<uint64_t> lpErrors;
+
+  for (size_t nIndex = 1; nIndex < lpEdges.size(); nIndex++)
+  {
+    int64_t lWidth    = (lpEdges[nIndex] - lpEdges[nIndex - 1]);
+    int64_t lExpected = ((int64_t)lpSchedule[nIndex] * 1000);
+
+    lpErrors.push_back(llabs(lWidth - lExpected));
+  }
+
+  PrintJitter("Pulse width error (captured)", GetStatistics(lpErrors));
+}
+
+int Benchmark_Jitter(int argc, char *argv[])
+{
+  if (argc < 3)
+  {
+    fprintf(
+      stderr,
+      "Usage: jitter <chip> <line> [frames] [loop chip] [loop line] [device]\n"
+    );
+
+    return 1;
+  }
+
+  string       sChip        = argv[1];
+  unsigned int uiOffset     = atoi(argv[2]);
+  size_t       nFrames      = ((argc > 3) ? atoi(argv[3]) : 10);
+  string       sCaptureChip = ((argc > 4) ? argv[4] : "");
+  unsigned int uiCapture    = ((argc > 5) ? atoi(argv[5]) : 0);
+  int          iDevice      = ((argc > 6) ? atoi(argv[6]) : -1);
+
+  if (!nFrames)
+  {
+    fprintf(stderr, "Invalid frame count.\n");
+    return 1;
+  }
+
+  // Same line code for both transmitters: the module one when compared
+
+  CGPIOWire GPIOWire((-1 == iDevice) ? 0 : iDevice);
+
+  if ((-1 != iDevice) && !GPIOWire.LoadConfiguration())
+  {
+    fprintf(stderr, "Cannot read the gpiowire%d configuration.\n", iDevice);
+    return 1;
+  }
+
+  mt19937               Random(1);
+  vector<unsigned char> lpMessage(JITTER_PAYLOAD_SIZE);
+
+  for (size_t nIndex = 0; nIndex < lpMessage.size(); nIndex++)
+  {
+    lpMessage[nIndex] = (unsigned char)Random();
+  }
+
+  vector<const unsigned char*> lpMessages(nFrames, lpMessage.data());
+  vector<size_t>               lpSizes(nFrames, lpMessage.size());
+  vector<uint32_t>             lpSchedule;
+  vector<size_t>               lpFrameEnds;
+
+  CGPIOWireLine::CreateSchedule(
+    GPIOWire.GetLineCode(),
+    lpMessages.data(),
+    lpSizes.data(),
+    nFrames,
+    lpSchedule,
+    lpFrameEnds
+  );
+
+  unique_ptr<CEdgeCapture> lpCapture;
+
+  if (!sCaptureChip.empty())
+  {
+    lpCapture.reset(new CEdgeCapture(sCaptureChip, uiCapture));
+
+    if (!lpCapture->IsOpen())
+    {
+      fprintf(stderr, "Cannot capture %s line %u.\n", sCaptureChip.c_str(), uiCapture);
+      return 1;
+    }
+  }
+
+  printf(
+    "%zu frames of %zu bytes, %zu edges\n\n",
+    nFrames,
+    lpMessage.size(),
+    lpSchedule.size()
+  );
+
+  // Userspace transmitter, then with a busy wait absorbing the wake up
+  // latency
+
+  const unsigned long lpSpinTimes[] = { 0, JITTER_SPIN_TIME };
+
+  for (unsigned long ulSpinTime : lpSpinTimes)
+  {
+    CGPIOWireLine Line(
+      sChip,
+      uiOffset,
+      GPIOWire.GetLineCode(),
+      false,
+      DEF_GPIO_LINE_PRIORITY,
+      ulSpinTime,
+      true // Dedicated process: memory locked
+    );
+
+    if (!Line.IsOpen())
+    {
+      fprintf(stderr, "%s\n", Line.GetLastResult().GetDescription().c_str());
+      return 1;
+    }
+
+    printf(
+      "Userspace, %s%s\n",
+      (ulSpinTime ? "clock_nanosleep() plus spin" : "clock_nanosleep()"),
+      (Line.IsRealTime() ? "" : " (no SCHED_FIFO/mlock: run as root)")
+    );
+
+    if (lpCapture)
+    {
+      lpCapture->Start();
+    }
+
+    SGPIOWireResult Result = Line.SendMessages(
+      lpMessages.data(),
+      lpSizes.data(),
+      nFrames
+    );
+
+    if (!Result)
+    {
+      fprintf(stderr, "%s\n", Result.GetDescription().c_str());
+    }
+
+    PrintJitter("Edge lateness (self)", Line.GetJitter());
+
+    if (lpCapture)
+    {
+      PrintPulseError(lpCapture->Stop(), lpSchedule);
+    }
+
+    printf("\n");
+  }
+
+  // Kernel module, measured by the loopback only
+
+  if (-1 != iDevice)
+  {
+    printf("Kernel module (gpiowire%d)\n", iDevice);
+
+    if (!lpCapture)
+    {
+      printf("  Needs a loopback line to be measured.\n");
+      return 0;
+    }
+
+    CGPIOWireSession Session = GPIOWire.OpenSession();
+
+    lpCapture->Start();
+
+    SGPIOWireResult Result = Session.SendMessages(
+      lpMessages.data(),
+      lpSizes.data(),
+      nFrames
+    );
+
+    if (!Result)
+    {
+      fprintf(stderr, "%s\n", Result.GetDescription().c_str());
+    }
+
+    PrintPulseError(lpCapture->Stop(), lpSchedule);
+  }
+
+  return 0;
+}
@@ -0,0 +1,252 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+// Builds the pre-shared compression dictionary (see library Compression.hpp)
+// from a message corpus (one message per line).
+//
+// Usage: gpiowire-dictionary <corpus> [max entries] > Dictionary.hpp
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+#define DEF_MAX_ENTRIES      127
+#define DEF_MIN_ENTRY_SIZE   2
+#define DEF_MAX_ENTRY_SIZE   16
+#define DEF_MIN_SAVING       4
+
+static bool IsLiteral(const string& sValue)
+{
+  for (size_t nIndex = 0; nIndex < sValue.length(); nIndex++)
+  {
+    if ((unsigned char)sValue[nIndex] >= 0x80)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static vector<string> SplitSegments(
+  const vector<string>& lpSegments,
+  const string&         sEntry
+)
+{
+  // Remove every entry occurrence, so further entries are chosen upon what
+  // the greedy compressor would still leave as literals.
+
+  vector<string> lpResult;
+
+  for (size_t nIndex = 0; nIndex < lpSegments.size(); nIndex++)
+  {
+    const string& sSegment = lpSegments[nIndex];
+    size_t        nStart   = 0;
+    size_t        nFound;
+
+    while (string::npos != (nFound = sSegment.find(sEntry, nStart)))
+    {
+      if (nFound > nStart)
+      {
+        lpResult.push_back(sSegment.substr(nStart, (nFound - nStart)));
+      }
+
+      nStart = (nFound + sEntry.length());
+    }
+
+    if (nStart < sSegment.length())
+    {
+      lpResult.push_back(sSegment.substr(nStart));
+    }
+  }
+
+  return lpResult;
+}
+
+static string Escape(const string& sValue)
+{
+  string sResult;
+  char   szOctal[8];
+
+  for (size_t nIndex = 0; nIndex < sValue.length(); nIndex++)
+  {
+    unsigned char cChar = sValue[nIndex];
+
+    if ((cChar < 0x20) || (cChar > 0x7E) || ('"' == cChar) || ('\\' == cChar))
+    {
+      snprintf(szOctal, sizeof(szOctal), "\\%03o", cChar);
+      sResult += szOctal;
+    }
+    else
+    {
+      sResult += (char)cChar;
+    }
+  }
+
+  return sResult;
+}
+
+int main(int argc, char *argv[])
+{
+  if (argc < 2)
+  {
+    fprintf(stderr, "Usage: %s <corpus> [max entries]\n", argv[0]);
+    return 1;
+  }
+
+  size_t nMaxEntries = ((argc > 2) ? atoi(argv[2]) : DEF_MAX_ENTRIES);
+
+  if ((nMaxEntries < 1) || (nMaxEntries > DEF_MAX_ENTRIES))
+  {
+    fprintf(stderr, "Max entries must be between 1 and %d.\n", DEF_MAX_ENTRIES);
+    return 1;
+  }
+
+  FILE* lpCorpus = fopen(argv[1], "r");
+
+  if (!lpCorpus)
+  {
+    fprintf(stderr, "Unable to open corpus \"%s\".\n", argv[1]);
+    return 1;
+  }
+
+  vector<string> lpSegments;
+  char*          lpszLine = NULL;
+  size_t         nLine    = 0;
+  ssize_t        nRead;
+
+  while ((nRead = getline(&lpszLine, &nLine, lpCorpus)) > 0)
+  {
+    if ('\n' == lpszLine[nRead - 1])
+    {
+      nRead--;
+    }
+
+    if (nRead > 0)
+    {
+      lpSegments.push_back(string(lpszLine, nRead));
+    }
+  }
+
+  free(lpszLine);
+  fclose(lpCorpus);
+
+  // Greedy selection of the substring saving the most bytes
+
+  vector<string> lpEntries;
+
+  while (lpEntries.size() < nMaxEntries)
+  {
+    map<string, size_t> lpCounters;
+
+    for (size_t nIndex = 0; nIndex < lpSegments.size(); nIndex++)
+    {
+      const string& sSegment = lpSegments[nIndex];
+
+      for (size_t nStart = 0; nStart < sSegment.length(); nStart++)
+      {
+        for (
+          size_t nSize = DEF_MIN_ENTRY_SIZE;
+          (nSize <= DEF_MAX_ENTRY_SIZE) && ((nStart + nSize) <= sSegment.length());
+          nSize++
+        )
+        {
+          lpCounters[sSegment.substr(nStart, nSize)]++;
+        }
+      }
+    }
+
+    string sBest;
+    size_t nBestSaving = 0;
+
+    for (
+      map<string, size_t>::const_iterator itCounter = lpCounters.begin();
+      itCounter != lpCounters.end();
+      ++itCounter
+    )
+    {
+      // Each occurrence saves (size - 1) bytes on air
+
+      size_t nSaving = (itCounter->second * (itCounter->first.length() - 1));
+
+      if ((nSaving > nBestSaving) && IsLiteral(itCounter->first))
+      {
+        sBest       = itCounter->first;
+        nBestSaving = nSaving;
+      }
+    }
+
+    if (nBestSaving < DEF_MIN_SAVING)
+    {
+      break;
+    }
+
+    lpEntries.push_back(sBest);
+    lpSegments = SplitSegments(lpSegments, sBest);
+
+    fprintf(
+      stderr,
+      "Entry #%zu \"%s\" saves %zu byte(s).\n",
+      lpEntries.size(),
+      sBest.c_str(),
+      nBestSaving
+    );
+  }
+
+  // Header shared by the transmitter library and the Arduino receiver
+
+  size_t nOffset = 0;
+
+  printf("// Generated by gpiowire-dictionary, do not edit.\n");
+  printf("// Copy it into both transmitter library and receiver project.\n");
+  printf("\n");
+  printf("#ifndef _DICTIONARY_HPP_\n");
+  printf("#define _DICTIONARY_HPP_\n");
+  printf("\n");
+  printf("#define DICTIONARY_ENTRY_COUNT %zu\n", lpEntries.size());
+  printf("\n");
+  printf("#define DICTIONARY_DATA \\\n");
+
+  for (size_t nIndex = 0; nIndex < lpEntries.size(); nIndex++)
+  {
+    printf("  \"%s\" \\\n", Escape(lpEntries[nIndex]).c_str());
+  }
+
+  printf("  \"\"\n");
+  printf("\n");
+  printf("#define DICTIONARY_OFFSETS \\\n");
+
+  for (size_t nIndex = 0; nIndex < lpEntries.size(); nIndex++)
+  {
+    printf("  %zu, \\\n", nOffset);
+    nOffset += lpEntries[nIndex].length();
+  }
+
+  printf("  %zu\n", nOffset);
+  printf("\n");
+  printf("#endif /* _DICTIONARY_HPP_ */\n");
+
+  return 0;
+}
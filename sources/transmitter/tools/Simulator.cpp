@@ -0,0 +1,358 @@
+/*
+
+GPIO-Wire for Cheap RF communications
+Copyright (C) 2016-2018 Antonio Petricca <antonio.petricca@gmail.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+// Predicts the delivered frame rate of N uncoordinated transmitters sharing
+// a channel with randomized slotting (see library GPIOWireSlotter.hpp), for
+// a range of slot windows: new frames arrive with the given total offered
+// load (new frames air time over time), each copy is lost when it overlaps
+// any other transmission, a frame is delivered when any of its copies is
+// not. Air times come from the module default line code.
+//
+// Traffic models:
+//
+//  - poisson  : independent random arrivals (slotting does not change the
+//               collision odds then, repeats do);
+//  - periodic : same report period, random phase, +/-100 ppm clock drift;
+//  - event    : every transmitter reacts (within 1 mS) to common events.
+//
+// Usage: gpiowire-simulator <transmitters> <load> [traffic] [payload size]
+//                           [repeats] [guard time]
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "GPIOWire.hpp"
+#include "GPIOWireSlotter.hpp"
+
+using namespace std;
+
+#define DEF_PAYLOAD_SIZE  16
+#define DEF_FRAME_COUNT   20000 // Per simulation
+#define DEF_SAMPLE_FRAMES 64    // Random payloads, for air time spread
+#define DEF_MAX_SLOTS     64
+#define DEF_CLOCK_DRIFT   0.0001 // Periodic traffic
+#define DEF_REACTION_TIME 1000   // uS, event traffic
+
+enum class SimulatorTraffic
+{
+  Poisson,
+  Periodic,
+  Event
+};
+
+struct SCopy
+{
+  uint64_t ulStart;
+  uint64_t ulEnd;
+  size_t   nFrame;
+};
+
+struct SSimulation
+{
+  double dDelivered;   // Delivered frames ratio
+  double dGoodput;     // Delivered frames air time over time
+  double dLatency;     // mS, from arrival to first copy received
+};
+
+static SSimulation Simulate(
+  CGPIOWire&                   GPIOWire,
+  const vector<unsigned long>& lpAirTimes,
+  size_t                       nTransmitters,
+  double                       dLoad,
+  SimulatorTraffic             Traffic,
+  const SGPIOWireSlotting&     Slotting
+)
+{
+  double dAirTime = 0.0;
+
+  for (size_t nIndex = 0; nIndex < lpAirTimes.size(); nIndex++)
+  {
+    dAirTime += lpAirTimes[nIndex];
+  }
+
+  dAirTime /= lpAirTimes.size();
+
+  // Frames per transmitter and their mean inter-arrival time (uS)
+
+  size_t nFrames      = (DEF_FRAME_COUNT / nTransmitters);
+  double dInterArrival = ((dAirTime * nTransmitters) / dLoad);
+
+  vector<SCopy>         lpCopies;
+  vector<uint64_t>      lpArrivals;
+  vector<unsigned long> lpFrameAirTimes;
+  vector<uint64_t>      lpOffsets;
+  uint64_t              ulDuration = 0;
+
+  for (size_t nTransmitter = 0; nTransmitter < nTransmitters; nTransmitter++)
+  {
+    CGPIOWireSlotter Slotter(GPIOWire, Slotting, (nTransmitter + 1));
+
+    mt19937                           Random(nTransmitter + 1);
+    mt19937                           Events(0); // Common to all
+    exponential_distribution<double>  Arrival(1.0 / dInterArrival);
+    uniform_real_distribution<double> Uniform(0.0, 1.0);
+    uniform_int_distribution<size_t>  Sample(0, (lpAirTimes.size() - 1));
+
+    double   dEvent   = 0.0;
+    double   dArrival = 0.0;
+    double   dPeriod  = (
+      dInterArrival * (1.0 + (DEF_CLOCK_DRIFT * ((Uniform(Random) * 2.0) - 1.0)))
+    );
+    uint64_t ulFree   = 0;
+
+    if (SimulatorTraffic::Periodic == Traffic)
+    {
+      dArrival = (Uniform(Random) * dInterArrival); // Phase
+    }
+
+    for (size_t nFrame = 0; nFrame < nFrames; nFrame++)
+    {
+      switch (Traffic)
+      {
+        case SimulatorTraffic::Poisson:
+          dArrival += Arrival(Random);
+          break;
+
+        case SimulatorTraffic::Periodic:
+          dArrival += ((nFrame > 0) ? dPeriod : 0.0);
+          break;
+
+        case SimulatorTraffic::Event:
+          dEvent  += Arrival(Events);
+          dArrival = (dEvent + (Uniform(Random) * DEF_REACTION_TIME));
+          break;
+      }
+
+      // One frame at a time per transmitter (blocking send)
+
+      uint64_t      ulArrival = (uint64_t)dArrival;
+      uint64_t      ulStart   = max(ulArrival, ulFree);
+      unsigned long ulAirTime = lpAirTimes[Sample(Random)];
+
+      Slotter.Plan(ulAirTime, lpOffsets);
+
+      for (size_t nCopy = 0; nCopy < lpOffsets.size(); nCopy++)
+      {
+        uint64_t ulCopyStart = (ulStart + lpOffsets[nCopy]);
+
+        lpCopies.push_back(
+          { ulCopyStart, (ulCopyStart + ulAirTime), lpArrivals.size() }
+        );
+      }
+
+      ulFree     = (ulStart + lpOffsets.back() + ulAirTime);
+      ulDuration = max(ulDuration, (uint64_t)dArrival);
+
+      lpArrivals.push_back(ulArrival);
+      lpFrameAirTimes.push_back(ulAirTime);
+    }
+  }
+
+  // A copy is lost when overlapping any other one
+
+  sort(
+    lpCopies.begin(),
+    lpCopies.end(),
+    [](const SCopy& Left, const SCopy& Right)
+    {
+      return (Left.ulStart < Right.ulStart);
+    }
+  );
+
+  vector<uint64_t> lpDelivered(lpArrivals.size(), UINT64_MAX);
+  uint64_t         ulMaxEnd = 0;
+
+  for (size_t nIndex = 0; nIndex < lpCopies.size(); nIndex++)
+  {
+    const SCopy& Copy = lpCopies[nIndex];
+
+    bool bLost = (
+         (ulMaxEnd > Copy.ulStart)
+      || (
+              ((nIndex + 1) < lpCopies.size())
+           && (lpCopies[nIndex + 1].ulStart < Copy.ulEnd)
+         )
+    );
+
+    ulMaxEnd = max(ulMaxEnd, Copy.ulEnd);
+
+    if (!bLost)
+    {
+      lpDelivered[Copy.nFrame] = min(lpDelivered[Copy.nFrame], Copy.ulEnd);
+    }
+  }
+
+  SSimulation Result  = { 0.0, 0.0, 0.0 };
+  size_t      nCount  = 0;
+  double      dOnAir  = 0.0;
+
+  for (size_t nFrame = 0; nFrame < lpArrivals.size(); nFrame++)
+  {
+    if (UINT64_MAX != lpDelivered[nFrame])
+    {
+      nCount++;
+      dOnAir          += lpFrameAirTimes[nFrame];
+      Result.dLatency += (lpDelivered[nFrame] - lpArrivals[nFrame]);
+    }
+  }
+
+  Result.dDelivered = ((double)nCount / lpArrivals.size());
+  Result.dGoodput   = (dOnAir / ulDuration);
+  Result.dLatency   = (nCount ? (Result.dLatency / nCount / 1000.0) : 0.0);
+
+  return Result;
+}
+
+int main(int argc, char *argv[])
+{
+  if (argc < 3)
+  {
+    fprintf(
+      stderr,
+      "Usage: %s <transmitters> <load> [poisson|periodic|event] "
+      "[payload size] [repeats] [guard time]\n",
+      argv[0]
+    );
+
+    return 1;
+  }
+
+  size_t        nTransmitters = atoi(argv[1]);
+  double        dLoad         = atof(argv[2]);
+  string        sTraffic      = ((argc > 3) ? argv[3] : "poisson");
+  size_t        nPayloadSize  = ((argc > 4) ? atoi(argv[4]) : DEF_PAYLOAD_SIZE);
+  unsigned int  uiRepeatCount = ((argc > 5) ? atoi(argv[5]) : 0);
+  unsigned long ulGuardTime   = ((argc > 6) ? atol(argv[6]) : DEF_GPIO_SLOT_GUARD);
+
+  SimulatorTraffic Traffic;
+
+  if ("poisson" == sTraffic)
+  {
+    Traffic = SimulatorTraffic::Poisson;
+  }
+  else if ("periodic" == sTraffic)
+  {
+    Traffic = SimulatorTraffic::Periodic;
+  }
+  else if ("event" == sTraffic)
+  {
+    Traffic = SimulatorTraffic::Event;
+  }
+  else
+  {
+    fprintf(stderr, "Unknown traffic model \"%s\".\n", sTraffic.c_str());
+    return 1;
+  }
+
+  if (
+       (nTransmitters < 1)
+    || (nTransmitters > DEF_FRAME_COUNT)
+    || (dLoad <= 0.0)
+    || (nPayloadSize < 1)
+    || (nPayloadSize > DEF_GPIO_ENCODER_MAX_LENGTH)
+    || (uiRepeatCount >= DEF_MAX_SLOTS)
+  )
+  {
+    fprintf(stderr, "Invalid arguments.\n");
+    return 1;
+  }
+
+  // Air times of random binary payloads (CRC, length prefix)
+
+  CGPIOWire             GPIOWire(0);
+  vector<unsigned long> lpAirTimes;
+  string                sPayload(nPayloadSize, '\0');
+  mt19937               Random(0);
+
+  GPIOWire.SetLengthPrefix(true);
+
+  for (size_t nSample = 0; nSample < DEF_SAMPLE_FRAMES; nSample++)
+  {
+    for (size_t nIndex = 0; nIndex < nPayloadSize; nIndex++)
+    {
+      sPayload[nIndex] = (char)Random();
+    }
+
+    size_t nSize = GPIOWire.CreateArenaMessage(sPayload, true);
+
+    lpAirTimes.push_back(GPIOWire.GetAirTime(GPIOWire.GetArenaMessage(), nSize));
+  }
+
+  printf("Transmitters     : %zu\n", nTransmitters);
+  printf("Offered load     : %.3f (%s)\n", dLoad, sTraffic.c_str());
+  printf("Frame air time   : %lu uS (payload %zu bytes)\n", lpAirTimes[0], nPayloadSize);
+  printf("Repeats          : %u\n", uiRepeatCount);
+  printf("Guard time       : %lu uS\n\n", ulGuardTime);
+
+  printf("Slots  Delivered  Goodput  Latency (mS)\n");
+
+  // No slotting at all (pure ALOHA) first, then growing windows
+
+  SGPIOWireSlotting Immediate = { 1, 0, 0, 0 };
+  SSimulation       Result    = Simulate(
+    GPIOWire,
+    lpAirTimes,
+    nTransmitters,
+    dLoad,
+    Traffic,
+    Immediate
+  );
+
+  printf(
+    "none   %8.2f%%  %7.3f  %12.1f\n",
+    (Result.dDelivered * 100.0),
+    Result.dGoodput,
+    Result.dLatency
+  );
+
+  for (unsigned int uiSlots = 1; uiSlots <= DEF_MAX_SLOTS; uiSlots *= 2)
+  {
+    if (uiSlots <= uiRepeatCount)
+    {
+      continue;
+    }
+
+    SGPIOWireSlotting Slotting = { uiSlots, uiRepeatCount, ulGuardTime, 0 };
+
+    Result = Simulate(
+      GPIOWire,
+      lpAirTimes,
+      nTransmitters,
+      dLoad,
+      Traffic,
+      Slotting
+    );
+
+    printf(
+      "%-5u  %8.2f%%  %7.3f  %12.1f\n",
+      uiSlots,
+      (Result.dDelivered * 100.0),
+      Result.dGoodput,
+      Result.dLatency
+    );
+  }
+
+  return 0;
+}